@@ -0,0 +1,185 @@
+/* Copyright (C) 2007-2008 Centro de Computacao Cientifica e Software Livre
+ * Departamento de Informatica - Universidade Federal do Parana - C3SL/UFPR
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301,
+ * USA.
+ */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ChessD BoT - A Free Chess Engine, intended to be used by children and teenagers
+learning how to play Chess.
+
+bench.c
+Benchmark module. Searches a fixed set of positions (openings, middlegames and
+endgames) with a deterministic configuration: no opening book, an empty
+transposition table for each position and no time limit. It reports the total
+of nodes searched, the time spent, the nodes per second and a signature of the
+node counts, which changes whenever the behaviour of the search changes.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "bench.h"
+#include "search.h"
+#include "transposition.h"
+
+/* Benchmark positions */
+static char *bench_positions[] = {
+    /* Openings */
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "r1bqkb1r/pppp1ppp/2n2n2/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+    "rnbqkb1r/ppp1pppp/5n2/3p4/2PP4/8/PP2PPPP/RNBQKBNR w KQkq - 1 3",
+    "rnbqk2r/ppp1ppbp/3p1np1/8/2PPP3/2N5/PP3PPP/R1BQKBNR w KQkq - 0 5",
+    "rnbqkb1r/pp3ppp/4pn2/2pp4/3P4/2P1PN2/PP3PPP/RNBQKB1R w KQkq - 0 5",
+    "r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/2P2N2/PP1P1PPP/RNBQK2R w KQkq - 1 5",
+    "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq c6 0 2",
+    /* Middlegames */
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+    "r3k2r/2pb1ppp/2pp1q2/p7/1nP1B3/1P2P3/P2N1PPP/R2QK2R w KQkq a6 0 14",
+    "4rrk1/2p1b1p1/p1p3q1/4p3/2P2n1p/1P1NR2P/PB3PP1/3R1QK1 b - - 2 24",
+    "r3qbrk/6p1/2b2pPp/p3pP1Q/PpPpP2P/3P1B2/2PB3K/R5R1 w - - 16 42",
+    "6k1/1R3p2/6p1/2Bp3p/3P2q1/P7/1P2rQ1K/5R2 b - - 4 44",
+    "8/8/1p2k1p1/3p3p/1p1P1P1P/1P2PK2/8/8 w - - 3 54",
+    "7r/2p3k1/1p1p1qp1/1P1Bp3/p1P2r1P/P7/4R3/Q4RK1 w - - 0 36",
+    "r1bq1rk1/pp2b1pp/n1pp1n2/3P1p2/2P1p3/2N1P2N/PP2BPPP/R1BQ1RK1 b - - 2 10",
+    "3r3k/2r4p/1p1b3q/p4P2/P2Pp3/1B2P3/3BQ1RP/6K1 w - - 3 87",
+    "2r4r/1p4k1/1Pnp4/3Qb1pq/8/4BpPp/5P2/2RR1BK1 w - - 0 42",
+    "4q1bk/6b1/7p/p1p4p/PNPpP2P/KN4P1/3Q4/4R3 b - - 0 37",
+    "2q3r1/1r2pk2/pp3pp1/2pP3p/P1Pb1BbP/1P4Q1/R3NPP1/4R1K1 w - - 2 34",
+    "1r2r2k/1b4q1/pp5p/2pPp1p1/P3Pn2/1P1B1Q1P/2R3P1/4BR1K b - - 1 37",
+    "r3kb1r/3n1pp1/p6p/2pPp2q/Pp2N3/3B2PP/1PQ2P2/R3K2R w KQkq - 0 18",
+    "2r1kb1r/1p1n1ppp/p3pn2/q2p4/3P4/2N1PN2/PPQ1BPPP/R3K2R w KQk - 4 12",
+    "r1b1k2r/ppq2ppp/2n1pn2/2bp4/2P5/P1N1PN2/1PQ2PPP/R1B1KB1R w KQkq - 1 8",
+    /* Endgames */
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/8/8/5kp1/P7/8/1K1N4 w - - 0 1",
+    "8/8/8/5N2/8/p7/8/2NK3k w - - 0 1",
+    "8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+    "8/8/1P6/5pr1/8/4R3/7k/2K5 w - - 0 1",
+    "8/2p4P/8/kr6/6R1/8/8/1K6 w - - 0 1",
+    "8/8/3P3k/8/1p6/8/1P6/1K3n2 b - - 0 1",
+    "8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 124",
+    "6k1/3b3r/1p1p4/p1n2p2/1PPNpP1q/P3Q1p1/1R1RB1P1/5K2 b - - 0 1",
+    "r2r1n2/pp2bk2/2p1p2p/3q4/3PN1QP/2P3R1/P4PP1/5RK1 w - - 0 1",
+    "8/8/8/4k3/8/8/4P3/4K3 w - - 0 1",
+    "8/8/4kpp1/3p1b2/p6P/2B5/6P1/6K1 b - - 0 1",
+    "8/6pk/1p6/8/PP3p1p/5P2/4KP1q/3Q4 w - - 0 1",
+    "8/k7/3p4/p2P1p2/P2P1P2/8/8/K7 w - - 0 1",
+};
+
+/* Run the benchmark, searching every position up to 'depth' plies, in
+ * 'workers' processes at the same time. The search keeps its state in module
+ * globals, so each worker is a process of its own, which searches its share
+ * of the positions and sends the node counts back through a pipe. */
+void bench(uint8_t depth, uint32_t workers) {
+    uint32_t positions = sizeof(bench_positions) / sizeof(char *), i, w;
+    uint64_t *nodes, total = 0, signature = BENCH_SIGNATURE_SEED, usec;
+    struct timeval start, end;
+    int (*fd)[2];
+    pid_t pid;
+
+    if(workers < 1)
+        workers = 1;
+    if(workers > positions)
+        workers = positions;
+
+    nodes = (uint64_t *) calloc(positions, sizeof(uint64_t));
+    fd = malloc(workers * sizeof(*fd));
+    if(nodes == NULL || fd == NULL)
+        quit("Error: Could not allocate memory for the benchmark!\n");
+
+    /* Deterministic configuration of the search */
+    init_search();
+    max_depth = depth;
+    max_nodes = 0;
+    post = FALSE;
+    config_alarm(BENCH_MAX_SECONDS);
+
+    printf("Benchmark: %u positions, depth %u, %u worker(s)\n", positions, depth, workers);
+    gettimeofday(&start, NULL);
+
+    /* Start the workers */
+    for(w = 0; w < workers; w++) {
+        if(pipe(fd[w]) == -1)
+            quit("Error: Could not create a pipe for the benchmark!\n");
+        pid = fork();
+        if(pid == -1)
+            quit("Error: Could not start a benchmark worker!\n");
+        if(pid == 0) {
+            close(fd[w][0]);
+            for(i = w; i < positions; i += workers)
+                nodes[i] = bench_position(i, bench_positions[i]);
+            for(i = w; i < positions; i += workers)
+                if(write(fd[w][1], &nodes[i], sizeof(uint64_t)) != sizeof(uint64_t))
+                    quit("Error: Could not send the benchmark results!\n");
+            close(fd[w][1]);
+            exit(0);
+        }
+        close(fd[w][1]);
+    }
+
+    /* Collect the node counts of each worker, in the order they were sent */
+    for(w = 0; w < workers; w++) {
+        for(i = w; i < positions; i += workers)
+            if(read(fd[w][0], &nodes[i], sizeof(uint64_t)) != sizeof(uint64_t))
+                quit("Error: A benchmark worker has failed!\n");
+        close(fd[w][0]);
+    }
+    while(wait(NULL) > 0);
+
+    gettimeofday(&end, NULL);
+    usec = (uint64_t) (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec);
+
+    /* The signature depends on the node count of every single position */
+    for(i = 0; i < positions; i++) {
+        total += nodes[i];
+        signature = (signature ^ nodes[i]) * BENCH_SIGNATURE_PRIME;
+    }
+
+    printf("Total nodes: %llu\n", (unsigned long long) total);
+    printf("Time (ms): %llu\n", (unsigned long long) usec / 1000);
+    printf("Nodes/second: %llu\n", (unsigned long long) (usec ? total * 1000000 / usec : 0));
+    printf("Signature: %016llx\n", (unsigned long long) signature);
+
+    free(nodes);
+    free(fd);
+}
+
+/* Search a single benchmark position. Returns the number of nodes searched */
+uint64_t bench_position(uint32_t n, char *fen) {
+    char coord[8];
+    uint64_t nodes;
+    move_t m;
+
+    board = set_board(fen);
+    if(board == NULL)
+        quit("Error: Invalid benchmark position!\n");
+
+    /* Every position starts with an empty transposition table, and nothing
+     * learned about the moves */
+    reset_transposition_table();
+    clear_move_ordering();
+    m = search(board);
+    nodes = get_search_nodes();
+
+    if(!move_to_coord(coord, &m))
+        strcpy(coord, "none");
+    printf("Position %2u: nodes %10llu move %s\n", n + 1, (unsigned long long) nodes, coord);
+
+    free(board);
+    board = NULL;
+    return nodes;
+}
@@ -0,0 +1,49 @@
+/* Copyright (C) 2007-2008 Centro de Computacao Cientifica e Software Livre
+ * Departamento de Informatica - Universidade Federal do Parana - C3SL/UFPR
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301,
+ * USA.
+ */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ChessD BoT - A Free Chess Engine, intended to be used by children and teenagers
+learning how to play Chess.
+
+bench.h
+Benchmark module header file. Contains the default benchmark parameters and the
+function prototypes.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include "main.h"
+
+/* Default depth and number of workers of the benchmark */
+#define BENCH_DEPTH 4
+#define BENCH_WORKERS 1
+/* Level used when none is chosen in the command line */
+#define BENCH_LEVEL "50"
+/* The benchmark is not limited by time */
+#define BENCH_MAX_SECONDS 86400
+
+/* Node count signature (FNV-1a over the node counts) */
+#define BENCH_SIGNATURE_SEED 0xcbf29ce484222325ULL
+#define BENCH_SIGNATURE_PRIME 0x100000001b3ULL
+
+/* Function prototypes */
+void bench(uint8_t depth, uint32_t workers);
+uint64_t bench_position(uint32_t n, char *fen);
+#endif
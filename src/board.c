@@ -29,6 +29,7 @@ the 'board_t' structure.
 #include "board.h"
 #include "moves.h"
 #include "history.h"
+#include "see.h"
 
 /* Masks for the board files (columns) */
 const bitboard_t file[FILES] = {
@@ -154,9 +155,6 @@ const bitline_t rot_mask_315[8][8] = {
 {0x7F,0x7F,0x7F,0x7F,0x7F,0x7F,0x7F,0x80},
 {0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF}};
 
-/* Zobrist hash keys, used to determine bitboard hashes */
-uint64_t zobrist_piece[COLORS][PIECES][RANKS][FILES], zobrist_castle[16], zobrist_enpassant[16], zobrist_white_onmove;
-
 /* Setup a board for a given FEN string */
 board_t *set_board(char *fen) {
     board_t *b;
@@ -220,6 +218,9 @@ board_t *set_board(char *fen) {
         b->rotation[COLORS][rot] = b->rotation[COLOR_BLACK][rot] | b->rotation[COLOR_WHITE][rot];
     }
 
+    /* Is the side on move in check? */
+    update_checks(b);
+
     return b;
 }
 
@@ -381,54 +382,21 @@ bitboard_t rotate_bitboard(bitboard_t orig, uint8_t rot) {
     return rotated;
 }
 
-/* Initialize zobrist hash keys for every board component */
-void init_zobrist_keys(void) {
-    uint8_t castle, enpassant, color, piece, y, x;
-
-    /* Set the seed of the random number generator */
-    srand(time(NULL));
-
-    /* Keys of the pieces for each position */
-    for(color = COLOR_BLACK; color < COLORS; color++)
-        for(piece = PAWN; piece < PIECES; piece++)
-            for(y = 0; y < 8; y++)
-                for(x = 0; x < 8; x++)
-                    zobrist_piece[color][piece][y][x] = rand64();
-
-    /* Keys of the castle conditions */
-    for(castle = 0; castle <= CASTLE_ALL; castle++)
-        zobrist_castle[castle] = rand64();
-
-    /* Keys of the en-passant conditions */
-    enpassant = 0;
-    ENPASSANT_SET_VALID(enpassant, TRUE);
-    for(x = 0; x < 8; x++) {
-        ENPASSANT_SET_FILE(enpassant, x);
-        zobrist_enpassant[enpassant] = rand64();
-    }
-    ENPASSANT_SET_VALID(enpassant, FALSE);
-    ENPASSANT_SET_FILE(enpassant, 0);
-    zobrist_enpassant[enpassant] = rand64();
-
-    /* Key of the white side on move */
-    zobrist_white_onmove = rand64();
-}
-
-/* Returns a random 64bit number */
-uint64_t rand64(void) {
-    return (uint64_t) rand() ^ ((uint64_t)rand() << 16)
-      ^ ((uint64_t)rand() << 32) ^ ((uint64_t)rand() << 48);
-}
-
 /* Checks the end game conditions */
 uint8_t end(board_t *b) {
     uint8_t status;
 
     /* Checkmate or Stalemate */
-    if((status = mate_or_stale(b)) != NO_MATE) {
+    if((status = mate_or_stale(b)) != NO_MATE)
         return status;
+    /* Or a draw by the rules */
+    return draw_rules(b);
+}
+
+/* Checks the draws by the rules, that don't need the moves of the board */
+uint8_t draw_rules(board_t *b) {
     /* Three move repetition */
-    } else if(repetition(b)) {
+    if(repetition(b)) {
         return REPETITION;
     /* Fifty moves rule */
     } else if(fifty_moves(b)) {
@@ -438,16 +406,16 @@ uint8_t end(board_t *b) {
         return TWO_KINGS;
     /* Not end of the game */
     } else {
-        return FALSE;
+        return NO_MATE;
     }
 }
 
 /* Check if a given king (bitboard with the king set) is being checked by the
- * opponent color (opp) */
-bool check(board_t *b, bitboard_t king, uint8_t opp) {
-    int8_t src, src_y, src_x, dst_y, dst_x, i, j, rot;
-    bitboard_t rotated;
-    bitline_t line, mask;
+ * opponent color (opp), known at compile time */
+SPECIALIZED bool check_color(board_t *b, bitboard_t king, const uint8_t opp) {
+    int8_t src, src_y, src_x, dst, dst_y, dst_x, i, j, rot;
+    bitboard_t sliders;
+    bitline_t line;
 
     for(; (src = FIRST_BIT(king)) != -1; CLEAR_BIT(king, src_y, src_x)) {
         src_y = src/8;
@@ -461,24 +429,22 @@ bool check(board_t *b, bitboard_t king, uint8_t opp) {
         if(moves_knight[src_y][src_x] & b->bitboard[opp][KNIGHT])
             return TRUE;
 
-        /* Opponent's sliding pieces */
+        /* Opponent's sliding pieces: the first pieces on each line from the
+         * king that are the opponent's (on the rotated bitboards), if they
+         * are queens and rooks (horizontal and vertical lines) or queens and
+         * bishops (diagonal lines) */
         for(rot = ROT_0; rot < ROTATIONS; rot++) {
             dst_y = rot_map[rot][src_y][src_x][Y];
             dst_x = rot_map[rot][src_y][src_x][X];
-            line = GET_LINE(b->rotation[COLORS][rot], dst_y);
-
-            if(rot == ROT_0 || rot == ROT_90) {
-                /* Queens and Rooks horizontal and vertical ranges */
-                rotated = rotate_bitboard(b->bitboard[opp][ROOK] | b->bitboard[opp][QUEEN], rot);
-                if(moves_slide[dst_x][line] & GET_LINE(rotated, dst_y))
+            line = moves_slide[dst_x][GET_LINE(b->rotation[COLORS][rot], dst_y)] & GET_LINE(b->rotation[opp][rot], dst_y);
+            if(rot == ROT_45)
+                line &= rot_mask_45[dst_y][dst_x];
+            else if(rot == ROT_315)
+                line &= rot_mask_315[dst_y][dst_x];
+            sliders = b->bitboard[opp][QUEEN] | b->bitboard[opp][(rot == ROT_0 || rot == ROT_90) ? ROOK : BISHOP];
+            for(; (dst = FIRST_BIT_LINE(line)) != -1; CLEAR_BIT(line, 0, dst))
+                if(GET_BIT(sliders, unrot_map[rot][dst_y][dst][Y], unrot_map[rot][dst_y][dst][X]))
                     return TRUE;
-            } else if(rot == ROT_45 || rot == ROT_315) {
-                /* Queens and Bishops diagonal ranges */
-                rotated = rotate_bitboard(b->bitboard[opp][BISHOP] | b->bitboard[opp][QUEEN], rot);
-                mask = (rot == ROT_45) ? rot_mask_45[dst_y][dst_x] : rot_mask_315[dst_y][dst_x];
-                if((moves_slide[dst_x][line] & mask) & GET_LINE(rotated, dst_y))
-                    return TRUE;
-            }
         }
 
         /* Opponent's pawns range */
@@ -493,43 +459,90 @@ bool check(board_t *b, bitboard_t king, uint8_t opp) {
     return FALSE;
 }
 
-/* Check if we are in a checkmate or stalemate */
-uint8_t mate_or_stale(board_t *b) {
-    uint8_t i, onmove = b->onmove;
-    bool in_check = TRUE;
-    move_list_t *list = gen_move_list(b, FALSE);
-
-    /* Try all the next moves */
-    for(i = 0; i < list->size && in_check; i++) {
-        move(b, list->move[i]);
-        if(!check(b, b->bitboard[onmove][KING], !onmove))
-            in_check = FALSE;
-        unmove(b);
+/* Check if a given king (bitboard with the king set) is being checked by the
+ * opponent color (opp) */
+bool check(board_t *b, bitboard_t king, uint8_t opp) {
+    if(opp == COLOR_WHITE)
+        return check_color(b, king, COLOR_WHITE);
+    else
+        return check_color(b, king, COLOR_BLACK);
+}
+
+/* Find the opponent's pieces that give check to the side on move, and the
+ * side on move's pieces pinned to its king (they can only move along the
+ * line of the pin), walking each line from the king */
+void update_checks(board_t *b) {
+    static const int8_t directions[8][2] = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1}};
+    int8_t king, king_y, king_x, y, x, i, j, onmove = b->onmove;
+    bitboard_t sliders, pin;
+
+    b->checkers = 0;
+    b->pinned = 0;
+    if((king = FIRST_BIT(b->bitboard[onmove][KING])) == -1)
+        return;
+    king_y = king/8;
+    king_x = king%8;
+
+    /* Knights */
+    b->checkers = moves_knight[king_y][king_x] & b->bitboard[!onmove][KNIGHT];
+
+    /* Pawns */
+    for(i = (onmove ? 1 : -1), j = -1; j <= 1; j += 2) {
+        y = king_y + i;
+        x = king_x + j;
+        if(y <= RANK_8 && y >= RANK_1 && x <= FILE_A && x >= FILE_H && GET_BIT(b->bitboard[!onmove][PAWN], y, x))
+            SET_BIT(b->checkers, y, x);
     }
 
-    /* Clears the space previously allocated for the move list */
-    clear_move_list(list);
+    /* Sliding pieces. The first four directions are the rook's, the others
+     * the bishop's. An opponent's slider first on a line gives check, and
+     * second, after a piece of ours, pins it */
+    for(i = 0; i < 8; i++) {
+        sliders = b->bitboard[!onmove][QUEEN] | b->bitboard[!onmove][i < 4 ? ROOK : BISHOP];
+        if(!sliders)
+            continue;
+        pin = 0;
+        for(y = king_y + directions[i][0], x = king_x + directions[i][1]; y <= RANK_8 && y >= RANK_1 && x <= FILE_A && x >= FILE_H; y += directions[i][0], x += directions[i][1]) {
+            if(!GET_BIT(b->rotation[COLORS][ROT_0], y, x))
+                continue;
+            if(GET_BIT(b->rotation[onmove][ROT_0], y, x)) {
+                if(pin)
+                    break;
+                SET_BIT(pin, y, x);
+                continue;
+            }
+            if(GET_BIT(sliders, y, x)) {
+                if(pin)
+                    b->pinned |= pin;
+                else
+                    SET_BIT(b->checkers, y, x);
+            }
+            break;
+        }
+    }
+}
 
-    /* If after all those moves we would still be in check, it's a mate.
-     * Otherwise, it's a stalemate (draw) */
-    if(in_check) {
-        if(check(b, b->bitboard[onmove][KING], !onmove))
-            return CHECK_MATE;
-        else
-            return STALE_MATE;
-    } else {
+/* Check if we are in a checkmate or stalemate: no legal move, in check or not */
+uint8_t mate_or_stale(board_t *b) {
+    if(has_legal_move(b))
         return NO_MATE;
-    }
+    else if(b->checkers)
+        return CHECK_MATE;
+    else
+        return STALE_MATE;
 }
 
-/* Three full-moves repetition */
+/* Three full-moves repetition. Only the boards since the last capture or pawn
+ * move (the half-move clock) can be the same, and only those with the same
+ * side on move, every second one (from the fourth back: a move of each side
+ * can't restore a board) */
 bool repetition(board_t *b) {
-    int8_t same = 1, i;
-    board_t *h;
+    uint32_t size = peek_history_size(), i;
+    int8_t same = 1;
 
-    /* Walk over the history, looking for early matching hashes (equal boards)*/
-    for(i = 0; (h = peek_history_board(i)) != NULL; i++) {
-        if(h->hash == b->hash) {
+    /* Walk back over the history, looking for matching hashes (equal boards) */
+    for(i = 4; i <= b->hm && i <= size; i += 2) {
+        if(peek_history_hash(size - i) == b->hash) {
             same++;
             /* If it matches 3 times, we have a draw */
             if(same == 3)
@@ -559,6 +572,11 @@ bool two_kings(board_t *b) {
     return TRUE;
 }
 
+/* Check if a color has any piece besides its pawns and king */
+bool has_pieces(board_t *b, uint8_t color) {
+    return (b->bitboard[color][BISHOP] | b->bitboard[color][KNIGHT] | b->bitboard[color][ROOK] | b->bitboard[color][QUEEN]) != 0;
+}
+
 /* Determines if the engine agrees with the draw offer or not */
 bool evaluate_draw(board_t *b) {
     uint8_t quantity[COLORS][PIECES], total[COLORS], piece, color;
@@ -588,6 +606,13 @@ bool evaluate_draw(board_t *b) {
                (b->bitboard[COLOR_WHITE][BISHOP] & WHITE_SQUARES &&
                b->bitboard[COLOR_BLACK][BISHOP] & WHITE_SQUARES))
                 return TRUE;
+        /* King and a minor piece or a rook for each side, of the same value
+         * and with no pawns: a draw, unless a piece can be won right now */
+        if(!quantity[COLOR_BLACK][PAWN] && !quantity[COLOR_WHITE][PAWN] &&
+           !quantity[COLOR_BLACK][QUEEN] && !quantity[COLOR_WHITE][QUEEN] &&
+           quantity[COLOR_BLACK][ROOK] == quantity[COLOR_WHITE][ROOK] &&
+           !winning_capture(b, COLOR_WHITE) && !winning_capture(b, COLOR_BLACK))
+            return TRUE;
     /* King vs. King */
     } else if(total[COLOR_BLACK] == 1 && total[COLOR_WHITE] == 1) {
         return TRUE;
@@ -596,7 +621,7 @@ bool evaluate_draw(board_t *b) {
 }
 
 /* Returns the number of bits in a bitboard */
-inline uint8_t count(bitboard_t bits) {
+uint8_t count(bitboard_t bits) {
     uint8_t c, y, x;
     int8_t pos;
     for(c = 0; (pos = FIRST_BIT(bits)) != -1; CLEAR_BIT(bits, y, x)) {
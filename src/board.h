@@ -60,6 +60,17 @@ manipulating boards, bitboards, bitlines and related structures.
 #define ROT_315 3
 #define ROTATIONS 4
 
+/* Ray directions. The first four go up in the bit index, the last four down */
+#define DIR_N 0
+#define DIR_W 1
+#define DIR_NW 2
+#define DIR_NE 3
+#define DIR_S 4
+#define DIR_E 5
+#define DIR_SE 6
+#define DIR_SW 7
+#define DIRECTIONS 8
+
 /* Coordinates, used in bitboard rotations */
 #define Y 0
 #define X 1
@@ -130,6 +141,7 @@ manipulating boards, bitboards, bitlines and related structures.
 #define SET_BIT(b,y,x) (b) |= (0x01ULL << ((y)*8+(x)))
 #define GET_BIT(b,y,x) (0x01ULL & ((b)>>(((y)*8)+(x))))
 #define GET_LINE(b,y) (0x0FFULL & (b)>>((y)*8))
+#define SQUARE(y,x) ((y)*8+(x))
 
 /* Defines for Linux */
 #if defined(Linux)
@@ -148,6 +160,9 @@ manipulating boards, bitboards, bitlines and related structures.
 #define FIRST_BIT_LINE(x) FIRST_BIT(x)
 #endif
 
+/* Last bit (most significant) of a bitboard, which must not be empty */
+#define LAST_BIT(x) (63 - __builtin_clzll(x))
+
 /* Bitboard and Bitline type, used all over the place */
 typedef uint64_t bitboard_t;
 typedef uint8_t bitline_t;
@@ -163,14 +178,19 @@ typedef struct {
     uint16_t hm : 6; /* Number of half-moves */
     uint16_t fm : 9; /* Numver of full-moves*/
     uint8_t castled; /* Flags indicating wheter a side has castled or not */
-} board_t; /* 8 x 25 + 4 = 204 bytes */
+    bitboard_t checkers; /* Opponent's pieces giving check to the side on move */
+    bitboard_t pinned; /* Pieces of the side on move pinned to their king */
+} board_t; /* 8 x 27 + 4 = 220 bytes */
 
 /* Arrays and variables used by other modules */
 extern const bitboard_t file[FILES];
 extern const bitboard_t rank[RANKS];
 extern const uint8_t rot_map[ROTATIONS][RANKS][FILES][COORDS], unrot_map[ROTATIONS][RANKS][FILES][COORDS];
-extern uint64_t zobrist_piece[COLORS][PIECES][RANKS][FILES], zobrist_castle[16], zobrist_enpassant[16], zobrist_white_onmove;
+/* Zobrist hash keys, generated at build time (see tablegen.c) */
+extern const uint64_t zobrist_piece[COLORS][PIECES][RANKS][FILES], zobrist_castle[16], zobrist_enpassant[16], zobrist_white_onmove;
 extern const bitline_t rot_mask_45[8][8], rot_mask_315[8][8];
+/* Squares on each direction from each square, generated at build time */
+extern const bitboard_t rays[DIRECTIONS][RANKS][FILES];
 
 /* Function prototypes */
 board_t *set_board(char *fen);
@@ -179,16 +199,17 @@ bool place_pieces(board_t *b, char *pp);
 bool set_castle(board_t *b, char *castle);
 bool set_enpassant(board_t *b, char *enpassant);
 bitboard_t rotate_bitboard(bitboard_t orig, uint8_t rot);
-void init_zobrist_keys(void);
-uint64_t rand64(void);
 uint8_t end(board_t *b);
+uint8_t draw_rules(board_t *b);
 bool check(board_t *b, bitboard_t king, uint8_t color);
+void update_checks(board_t *b);
 uint8_t mate_or_stale(board_t *b);
 bool fifty_moves(board_t *b);
 bool two_kings(board_t *b);
+bool has_pieces(board_t *b, uint8_t color);
 bool repetition(board_t *b);
 bool evaluate_draw(board_t *b);
-inline uint8_t count(bitboard_t bits);
+uint8_t count(bitboard_t bits);
 void print_board(board_t *b);
 char *print_fen(board_t *b);
 
@@ -31,15 +31,24 @@ Shares data with Search Thread (search.c).
 #include "cecp.h"
 #include "history.h"
 #include "eco.h"
+#include "timeman.h"
+
+/* The engine analyzes every position it gets, instead of playing */
+static bool analyze_mode = FALSE;
 
 /* CECP Thread main function */
 void *cecp_loop(void *arg) {
     bool end_loop = FALSE;
     char command[MAX_SIZE_BUFFER];
 
+    /* The board is set up by the Search Thread */
+    wait_search_thread();
+
     while(!end_loop) {
-        /* Read commands from stdin and interpret them accordingly */
-        fgets(command, MAX_SIZE_BUFFER, stdin);
+        /* Read commands from stdin and interpret them accordingly. Without
+         * an interface anymore, quit */
+        if(fgets(command, MAX_SIZE_BUFFER, stdin) == NULL)
+            strcpy(command, "quit");
         end_loop = cecp_command(ltrim(command));
     }
 
@@ -59,6 +68,11 @@ bool cecp_command(char *c) {
     if(c[strlen(c)-1] == '\n')
         c[strlen(c)-1] = '\0';
 
+    /* Most commands need the real board (or change what the engine is doing):
+     * stop the search before them */
+    if(!keeps_searching(c))
+        stop_search(NULL);
+
     /* Select command */
     if(!strncmp(c, "xboard", 6)) {
         answer_xboard();
@@ -93,10 +107,12 @@ bool cecp_command(char *c) {
         answer_st(c);
     } else if(!strncmp(c, "sd ", 3)) {
         answer_sd(c);
+    } else if(!strncmp(c, "nodes ", 6)) {
+        answer_nodes(c);
     } else if(!strncmp(c, "time ", 5)) {
-        answer_time();
+        answer_time(c);
     } else if(!strncmp(c, "otim ", 5)) {
-        answer_otim();
+        answer_otim(c);
     } else if(!strncmp(c, "usermove ", 9)) {
         answer_usermove(&c[9]);
     } else if(!strncmp(c, "?", 1)) {
@@ -129,6 +145,12 @@ bool cecp_command(char *c) {
         answer_nopost();
     } else if(!strncmp(c, "analyze", 7)) {
         answer_analyze();
+    } else if(!strncmp(c, "exit", 4)) {
+        answer_exit();
+    } else if(!strcmp(c, ".")) {
+        answer_dot();
+    } else if(!strncmp(c, "option ", 7)) {
+        answer_option(&c[7]);
     } else if(!strncmp(c, "name ", 5)) {
         answer_name();
     } else if(!strncmp(c, "rating ", 7)) {
@@ -147,9 +169,25 @@ bool cecp_command(char *c) {
         printf("Error (unknown command): %s\n", c);
     }
 
+    /* In analyze mode, the analysis goes on from the current position */
+    if(analyze_mode && (get_status() == NOP || get_status() == FORCE))
+        set_status(ANALYZE);
+
     return FALSE;
 }
 
+/* Commands that can be answered while the engine searches or ponders */
+bool keeps_searching(char *c) {
+    return !strncmp(c, "usermove ", 9) || !strncmp(c, "time ", 5) ||
+        !strncmp(c, "otim ", 5) || !strncmp(c, "ping ", 5) ||
+        !strncmp(c, "?", 1) || !strncmp(c, "draw", 4) ||
+        !strncmp(c, "hint", 4) || !strncmp(c, "post", 4) ||
+        !strncmp(c, "nopost", 6) || !strncmp(c, "hard", 4) ||
+        !strncmp(c, "easy", 4) || !strncmp(c, "name ", 5) ||
+        !strncmp(c, "rating ", 7) || !strncmp(c, "computer", 8) ||
+        !strncmp(c, "accepted", 8) || !strcmp(c, ".") || !strcmp(c, "");
+}
+
 /* The 'xboard' command is the first one received by the engine.
  * If the engine has some kind of output (i. e. prompt), it must turn it off. */
 void answer_xboard(void) {
@@ -161,9 +199,10 @@ void answer_xboard(void) {
 void answer_protover(char *c) {
     int tmp = 0;
     char **f, *features[] = {"ping=1", "setboard=1" , "playother=1", "san=0",
-    "usermove=1", "time=0", "draw=1", "sigint=0", "sigterm=0","reuse=1",
-    "analyze=0", "myname=\"ChessD BoT\"", "variants=\"normal\"", "colors=0",
-    "ics=0", "name=1", "pause=0", "done=1", NULL};
+    "usermove=1", "time=1", "draw=1", "sigint=0", "sigterm=0","reuse=1",
+    "analyze=1", "myname=\"ChessD BoT\"", "variants=\"normal\"", "colors=0",
+    "ics=0", "name=1", "pause=0", "option=\"MultiPV -spin 1 1 8\"", "done=1",
+    NULL};
 
     /* If its not version 2, do nothing */
     if(!(sscanf(c, "protover %d", &tmp) == 1 && tmp == 2))
@@ -192,6 +231,8 @@ void answer_rejected(void) {
 void answer_new(void) {
     pthread_mutex_lock(&mutex);
     init_history();
+    clear_move_ordering();
+    reset_clocks();
     clear_board(board);
     board = set_board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
     if(board == NULL)
@@ -229,25 +270,10 @@ void answer_force(void) {
 /* Leave force mode and set the engine to play the color that is on move.
  * Start thinking and eventually make a move. */
 void answer_go(void) {
-    char out[MAX_SIZE_BUFFER];
-    move_t *m;
-
-    /* Set search thread to search mode and wait */
-    set_status_and_wait(SEARCH);
-
-    /* Get the move just played by us */
-    m = peek_history_move_top();
-
-    /* Translate to string and tell our move to the opponent */
-    if(!move_to_coord(out, m))
-        quit("Error: Bad move!\n");
-    printf("move %s\n", out);
-
-    /* Check end game conditions */
-    check_game_over();
+    /* Set search thread to search mode. It plays the move when it's done */
+    set_status(SEARCH);
 }
 
-
 /* Leave force mode and set the engine to play the color that is not on move.
  * If the engine later receives a move, it should start thinking and eventually
  * reply. */
@@ -275,17 +301,13 @@ void answer_level(char *c) {
     char *tok1 = NULL, *tok2 = NULL, *save1 = NULL, *save2 = NULL;
     uint32_t moves = 40, base = 300, inc = 0;
 
-    /* Get Moves per time control */
+    /* Get Moves per time control (zero for the whole game) */
     tok1 = strtok_r(c, " ", &save1);
     if(tok1)
         moves = atoi(tok1);
     else
         return;
 
-    /* In order to avoid division by zero, set moves value to default */
-    if(moves == 0)
-        moves = 40;
-
     /* Get minutes [and seconds] in each tim control */
     tok1 = strtok_r(NULL, " ", &save1);
     tok2 = strtok_r(tok1, ":", &save2);
@@ -307,50 +329,64 @@ void answer_level(char *c) {
     else
         return;
 
-    /* Configure alarm settings */
-    if(((base / moves) + inc) < get_config_alarm())
-        config_alarm((base / moves) + inc);
+    /* Configure the time manager */
+    set_time_control(moves, (uint64_t) base * 1000, (uint64_t) inc * 1000);
 }
 
 /* Set an exact number of seconds per move. */
 void answer_st(char *c) {
     int n;
     if(sscanf(c, "st %d", &n) == 1 && n > 0)
-        config_alarm(n);
+        set_time_per_move((uint64_t) n * 1000);
 }
 
 /* The engine should limit its thinking to the given number of ply. */
 void answer_sd(char *c) {
     int n;
-    if(sscanf(c, "sd %d", &n) == 1 && n >= 2)
-        max_depth = n;
+    if(sscanf(c, "sd %d", &n) == 1 && n >= 1)
+        max_depth = MIN(n, MAX_PLY - 1);
 }
 
-/* Set a clock that always belongs to the engine.
- * This command is disabled by the engine via the 'feature' command. */
-void answer_time(void) {
-    /* Not used */
+/* The engine should limit its thinking to the given number of nodes (zero
+ * for no limit). */
+void answer_nodes(char *c) {
+    long long n;
+    if(sscanf(c, "nodes %lld", &n) == 1 && n >= 0)
+        max_nodes = (uint64_t) n;
 }
 
-/* Set a clock that always belongs to the opponent.
- * This command is disabled by the engine via the 'feature' command. */
-void answer_otim(void) {
-    /* Not used */
+/* Set a clock that always belongs to the engine (in centiseconds). */
+void answer_time(char *c) {
+    long n;
+    if(sscanf(c, "time %ld", &n) == 1)
+        set_engine_clock(MAX(n, 0) * 10);
+}
+
+/* Set a clock that always belongs to the opponent (in centiseconds). */
+void answer_otim(char *c) {
+    long n;
+    if(sscanf(c, "otim %ld", &n) == 1)
+        set_opponent_clock(MAX(n, 0) * 10);
 }
 
 /* Receives a user's move. If the move is illegal, print an error message.
  * If the move is legal and in turn, make it. If not in force mode, start
  * thinking, and eventually make a move.*/
 void answer_usermove(char *c) {
-    static char out[MAX_SIZE_BUFFER];
-    static move_t *m, userm;
+    static move_t userm;
 
     /* If the user's move is invalid, return */
     if(!coord_to_move(c, &userm)) {
+        stop_search(NULL);
         printf("Illegal move: %s\n", c);
         return;
     }
 
+    /* Ponder hit: the search on the expected move goes on, and eventually
+     * plays our move. On a miss, the board is back to the real position */
+    if(stop_search(&userm))
+        return;
+
     /* Check if the movement is valid or not */
     if(!check_valid_move(board, userm)) {
         printf("Illegal move: %s\n", c);
@@ -360,27 +396,38 @@ void answer_usermove(char *c) {
     /* Perform the move if its valid */
     move(board, userm);
 
+    /* In analyze mode, the analysis just goes on from the new position */
+    if(analyze_mode)
+        return;
+
     /* Check end game conditions */
     if(!check_game_over() && get_status() != FORCE) {
-        /* Set search thread to search mode and wait */
-        set_status_and_wait(SEARCH);
+        /* Set search thread to search mode. It plays the move when it's done */
+        set_status(SEARCH);
+    }
+}
 
-        /* Get the move just played by us */
-        m = peek_history_move_top();
+/* Tell the opponent the move just played by us (called by the Search Thread).
+ * Returns FALSE if it has ended the game */
+bool answer_move(void) {
+    char out[MAX_SIZE_BUFFER];
+    move_t *m;
 
-        /* Translate to string and tell our move to the opponent */
-        if(!move_to_coord(out, m))
-            quit("Error: Bad move!\n");
-        printf("move %s\n", out);
+    /* Get the move just played by us */
+    m = peek_history_move_top();
 
-        /* Check end game conditions */
-        check_game_over();
-    }
+    /* Translate to string and tell our move to the opponent */
+    if(!move_to_coord(out, m))
+        quit("Error: Bad move!\n");
+    printf("move %s\n", out);
+
+    /* Check end game conditions */
+    return !check_game_over();
 }
 
-/* Stops search process at once */
+/* Stops search process at once, playing the best move found so far */
 void answer_interrogation(void) {
-    set_timeout(TRUE);
+    move_now();
 }
 
 /* When the engine recieves this command, it must reply with a 'pong' and the
@@ -394,8 +441,7 @@ void answer_ping(char *c) {
 /* The engine's opponent offers the engine a draw. */
 void answer_draw(void) {
     /* The Engine accepts the draw offer, if it considers the position a draw */
-    if(evaluate_draw(board))
-        printf("offer draw\n");
+    offer_draw();
 }
 
 /* Receives the score and the reason for the game to be finished. */
@@ -409,6 +455,7 @@ void answer_result(void) {
 void answer_setboard(char *c) {
     pthread_mutex_lock(&mutex);
     init_history();
+    clear_move_ordering();
     clear_board(board);
     board = set_board(c);
     if(board == NULL)
@@ -425,9 +472,14 @@ void answer_edit(void) {
     /* Not used */
 }
 
-/* The opponent has asked for a move hint. This engine does not give hints. */
+/* The opponent has asked for a move hint. The hint is the opponent's move
+ * expected by the principal variation of our last search. */
 void answer_hint(void) {
-    /* nop */
+    char out[MAX_SIZE_BUFFER];
+    move_t m;
+
+    if(get_expected_move(&m) && move_to_coord(out, &m))
+        printf("Hint: %s\n", out);
 }
 
 
@@ -448,28 +500,50 @@ void answer_remove(void) {
 }
 
 /* Turn on pondering (thinking on the opponent's time, also known as
- * "permanent brain"). Pondering not implemented */
+ * "permanent brain"). It starts after our next move */
 void answer_hard(void) {
-    /* nop */
+    set_ponder(TRUE);
 }
 
-/* Turn off pondering. Pondering not implemented */
+/* Turn off pondering */
 void answer_easy(void) {
-    /* nop */
+    set_ponder(FALSE);
 }
 
-/* Turn on thinking/pondering output. Pondering not implemented */
+/* Turn on thinking/pondering output */
 void answer_post(void) {
-    /* nop */
+    post = TRUE;
 }
 
-/* Turn off thinking/pondering output. Pondering not implemented */
+/* Turn off thinking/pondering output */
 void answer_nopost(void) {
+    post = FALSE;
 }
 
-/* Enter "analyze" mode. This engine does not support "analyze" mode. */
+/* Enter "analyze" mode: search the current position with no limit, showing
+ * the best line as it changes. Moves, 'undo' and 'new' change the position
+ * under analysis; the transposition table is kept between them */
 void answer_analyze(void) {
-    /* nop */
+    analyze_mode = TRUE;
+}
+
+/* Leave "analyze" mode. The engine stays in force mode */
+void answer_exit(void) {
+    analyze_mode = FALSE;
+    set_status(FORCE);
+}
+
+/* Set an engine option, as 'option NAME=VALUE'. The only one is MultiPV, the
+ * number of best lines to search for (and show) */
+void answer_option(char *c) {
+    int n;
+    if(sscanf(c, "MultiPV=%d", &n) == 1 && n >= 1)
+        multi_pv = MIN(n, MAX_MULTI_PV);
+}
+
+/* Show the state of the analysis */
+void answer_dot(void) {
+    print_search_status();
 }
 
 /* This command informs the engine of its opponent's name. */
@@ -49,14 +49,16 @@ void answer_quit(void);
 void answer_random(void);
 void answer_force(void);
 void answer_go(void);
+bool answer_move(void);
 void answer_playother(void);
 void answer_white(void);
 void answer_black(void);
 void answer_level(char *c);
 void answer_st(char *c);
 void answer_sd(char *c);
-void answer_time(void);
-void answer_otim(void);
+void answer_nodes(char *c);
+void answer_time(char *c);
+void answer_otim(char *c);
 void answer_usermove(char *c);
 void answer_interrogation(void);
 void answer_ping(char *c);
@@ -73,6 +75,9 @@ void answer_easy(void);
 void answer_post(void);
 void answer_nopost(void);
 void answer_analyze(void);
+void answer_exit(void);
+void answer_dot(void);
+void answer_option(char *c);
 void answer_name(void);
 void answer_rating(void);
 void answer_ics(void);
@@ -80,5 +85,6 @@ void answer_computer(void);
 void answer_pause(void);
 void answer_resume(void);
 bool check_game_over(void);
+bool keeps_searching(char *c);
 
 #endif
@@ -36,64 +36,78 @@ by the chess engine.
 bool can_use_eco = TRUE;
 static eco_t *eco = NULL;
 
-/* Loads the 'Encyclopaedia of Chess Openings' into the 'eco_t' structure */
+/* Loads the 'Encyclopaedia of Chess Openings' into the 'eco_t' structure.
+ * The file is streamed, so the tree is built as the openings are read. */
 bool load_eco(board_t *b) {
-    char *san;
-    move_t move_coord;
-    uint8_t moves, i;
-    eco_t *e;
-    xml_node_t *root, **opening_list, **opening, **move_list, **mov;
+    eco_loader_t loader;
 
     /* If board is invalid, return error */
     if(b == NULL)
         return FALSE;
 
-    /* Open ECO file */
-    root = xml_parser(ECO_FILE);
-
     eco = init_eco();
 
-    opening_list = get_elements_by_tag_name(root, "opening");
-    if(opening_list == NULL)
+    /* Parse the ECO file, building the tree while reading it */
+    memset(&loader, 0, sizeof(eco_loader_t));
+    loader.board = b;
+    xml_stream(ECO_FILE, eco_tag_start, eco_tag_end, NULL, &loader);
+
+    if(loader.openings == 0)
         quit("Error: Missing 'opening' tag in ECO file!\n");
-    /* For each opening */
-    for(opening = opening_list; *opening; opening++) {
-        moves = 0;
-        e = eco;
-        move_list = get_elements_by_tag_name(*opening, "move");
-        if(move_list == NULL)
-            quit("Error: Missing 'opening' tag in ECO file!\n");
-        /* For each move of the opening */
-        for(mov = move_list; *mov; mov++) {
-            san = get_attribute(*mov, "san");
-            if(san == NULL)
-                quit("Error: Missing 'san' attribute at 'move' element in ECO file!\n");
-            /* Translate SAN move to move structure */
-            if(!san_to_move(b, san, &move_coord))
-                quit("Error: Could not translate from SAN to Coord notation!\n");
-
-            /* Insert the move in the ECO tree */
-            e = add_opening_move(e, move_coord);
-
-            /* Follow that move */
-            move(b, move_coord);
-            moves++;
-        }
-        /* Set blank move and add it as final token of the opening */
-        SET_BLANK_MOVE(move_coord);
-        e = add_opening_move(e, move_coord);
 
-        /* Undo moves */
-        for(i = 0; i < moves; i++)
-            unmove(b);
+    return TRUE;
+}
 
-        free(move_list);
+/* Streaming handler for the starting tags of the ECO file */
+void eco_tag_start(void *data, const XML_Char *name, const XML_Char **attrs) {
+    eco_loader_t *loader = (eco_loader_t *) data;
+    move_t move_coord;
+    char *san;
+
+    /* A new opening always starts from the root of the tree */
+    if(!strcmp(name, "opening")) {
+        loader->node = eco;
+        loader->moves = 0;
+        loader->openings++;
+    /* Each move follows the previous one of the same opening */
+    } else if(!strcmp(name, "move")) {
+        if(loader->node == NULL)
+            quit("Error: Missing 'opening' tag in ECO file!\n");
+        san = get_stream_attribute(attrs, "san");
+        if(san == NULL)
+            quit("Error: Missing 'san' attribute at 'move' element in ECO file!\n");
+        /* Translate SAN move to move structure */
+        if(!san_to_move(loader->board, san, &move_coord))
+            quit("Error: Could not translate from SAN to Coord notation!\n");
+
+        /* Insert the move in the ECO tree */
+        loader->node = add_opening_move(loader->node, move_coord);
+
+        /* Follow that move */
+        move(loader->board, move_coord);
+        loader->moves++;
     }
-    free(opening_list);
+}
 
-    clean_xml_node(root);
+/* Streaming handler for the ending tags of the ECO file */
+void eco_tag_end(void *data, const XML_Char *name) {
+    eco_loader_t *loader = (eco_loader_t *) data;
+    move_t move_coord;
 
-    return TRUE;
+    if(strcmp(name, "opening"))
+        return;
+
+    if(loader->moves == 0)
+        quit("Error: Missing 'move' tag in ECO file!\n");
+
+    /* Set blank move and add it as final token of the opening */
+    SET_BLANK_MOVE(move_coord);
+    add_opening_move(loader->node, move_coord);
+
+    /* Undo moves */
+    for(; loader->moves > 0; loader->moves--)
+        unmove(loader->board);
+    loader->node = NULL;
 }
 
 /* Starts a fresh new, empty eco_t structure */
@@ -171,11 +185,7 @@ bool query_eco(move_t *query) {
 
     for(i = 0; (m = peek_history_move(i)) != NULL && e->children > 0; i++) {
         for(j = 0; j < e->children; j++)
-            if(m->src_x == e->child[j].move.src_x &&
-               m->src_y == e->child[j].move.src_y &&
-               m->dst_x == e->child[j].move.dst_x &&
-               m->dst_y == e->child[j].move.dst_y &&
-               m->promotion == e->child[j].move.promotion)
+            if(SAME_MOVE(*m, e->child[j].move))
                 break;
         if(j < e->children) {
             e = &e->child[j];
@@ -188,12 +198,8 @@ bool query_eco(move_t *query) {
 
     /* The match has walked towards an opening, or we are the first to move */
     if(match || i == 0) {
-        memcpy(query, &e->child[rand() % e->children].move, sizeof(move_t));
-        if(query->src_x == 0 && query->src_y == 0 && query->dst_x == 0 &&
-           query->dst_y == 0 && query->promotion == NO_PROMOTION)
-            return FALSE;
-        else
-            return TRUE;
+        *query = e->child[rand() % e->children].move;
+        return !IS_BLANK_MOVE(*query);
     }
 
     return FALSE;
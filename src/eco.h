@@ -33,6 +33,7 @@ definition, ECO manipulation function prototypes, and also a path for the
 #include "main.h"
 #include "board.h"
 #include "moves.h"
+#include "xml.h"
 
 extern bool can_use_eco;
 
@@ -47,8 +48,18 @@ struct eco {
     eco_t *child;     /* List of children nodes */
 };
 
+/* State kept while streaming the ECO file */
+typedef struct {
+    board_t *board;    /* Board where the opening moves are played */
+    eco_t *node;       /* Current node of the ECO tree */
+    uint8_t moves;     /* Moves played so far in the current opening */
+    uint32_t openings; /* Number of openings read */
+} eco_loader_t;
+
 /* Function prototypes */
 bool load_eco(board_t *b);
+void eco_tag_start(void *data, const XML_Char *name, const XML_Char **attrs);
+void eco_tag_end(void *data, const XML_Char *name);
 eco_t *init_eco(void);
 void clear_eco(void);
 void clear_eco_node(eco_t *e);
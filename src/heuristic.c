@@ -30,8 +30,6 @@ Heuristic module. Contains the Function of Static Analysis for the leaf nodes of
 #include "moves.h"
 #include "levels.h"
 
-static bitboard_t king_distance[RANKS][FILES][8];
-static uint8_t dist[RANKS][FILES][RANKS][FILES];
 static uint8_t material_value[PIECES];
 
 /* Static Evaluation Function */
@@ -525,46 +523,13 @@ int32_t control(board_t *b, uint8_t onmove, uint8_t piece, int8_t src_y, int8_t
     return result;
 }
 
-/* Initialize useful distance matrices */
-void precompute_distances(void) {
-    uint8_t src, src_y, src_x, dst, dst_y, dst_x, d, i, dx, dy;
-
-    /* Fill the king's distances with zeros */
-    for(src = 0; src < 64; src++)
-        for(d = 0; d < 8; d++)
-            king_distance[src/8][src%8][d] = 0;
-
-    /* Calculate the distances matrix (euclidean distance) */
-    for(src = 0; src < 64; src++)
-        for(dst = 0; dst < 64; dst++) {
-            src_y = src/8;
-            src_x = src%8;
-            dst_y = dst/8;
-            dst_x = dst%8;
-            dx = src_x > dst_x ? src_x - dst_x : dst_x - src_x;
-            dy = src_y > dst_y ? src_y - dst_y : dst_y - src_y;
-            dist[src_y][src_x][dst_y][dst_x] = MAX(dx,dy);
-        }
-
-    /* Set the bitboards accordingly with king moves */
-    for(src = 0; src < 64; src++)
-        for(dst = 0; dst < 64; dst++) {
-            src_y = src/8;
-            src_x = src%8;
-            dst_y = dst/8;
-            dst_x = dst%8;
-            SET_BIT(king_distance[src_y][src_x][dist[src_y][src_x][dst_y][dst_x]], dst_y, dst_x);
-        }
-
-    /* Add the lesser distances to each bitboard */
-    for(src = 0; src < 64; src++)
-        for(d = 0; d < 8; d++)
-            for(i = 0; i < d; i++) {
-                src_y = src/8;
-                src_x = src%8;
-                king_distance[src_y][src_x][d] |= king_distance[src_y][src_x][i];
-            }
+/* Returns the value of a piece, in the same units of the evaluation */
+int32_t piece_value(uint8_t piece) {
+    return material_value[piece] * config->factor_material;
+}
 
+/* Initialize the material values of the pieces from the selected level */
+void init_material_values(void) {
     material_value[PAWN] = config->pawn_val;
     material_value[BISHOP] = config->bishop_val;
     material_value[KNIGHT] = config->knight_val;
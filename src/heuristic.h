@@ -32,6 +32,10 @@ components, and also the prototypes of the components.
 #include "main.h"
 #include "board.h"
 
+/* Distance tables, generated at build time (see tablegen.c) */
+extern const bitboard_t king_distance[RANKS][FILES][8];
+extern const uint8_t dist[RANKS][FILES][RANKS][FILES];
+
 /* Function prototypes */
 int32_t heuristic(board_t *, uint8_t);
 int32_t material(board_t *b, uint8_t onmove);
@@ -47,5 +51,6 @@ int32_t knight(board_t *b, uint8_t onmove);
 int32_t queen(board_t *b, uint8_t onmove);
 int32_t rook(board_t *b, uint8_t onmove);
 int32_t control(board_t *b, uint8_t onmove, uint8_t piece, int8_t src_y, int8_t src_x);
-void precompute_distances(void);
+int32_t piece_value(uint8_t piece);
+void init_material_values(void);
 #endif
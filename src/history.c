@@ -41,6 +41,9 @@ void init_history(void) {
     history.move = (move_t *) malloc(history.max_size * sizeof(move_t));
     if(history.move == NULL)
         quit("Error: Could not create history log!\n");
+    history.hash = (bitboard_t *) malloc(history.max_size * sizeof(bitboard_t));
+    if(history.hash == NULL)
+        quit("Error: Could not create history log!\n");
 }
 
 /* Clear the history */
@@ -51,6 +54,9 @@ void clear_history(void) {
     if(history.move)
         free(history.move);
     history.move = NULL;
+    if(history.hash)
+        free(history.hash);
+    history.hash = NULL;
 }
 
 /* Save a board and a move into the history stack */
@@ -60,12 +66,14 @@ void push_history(board_t *b, move_t m) {
             history.max_size += HISTORY_PAGE_SIZE;
             history.board = (board_t *) realloc(history.board, history.max_size * sizeof(board_t));
             history.move = (move_t *) realloc(history.move, history.max_size * sizeof(move_t));
+            history.hash = (bitboard_t *) realloc(history.hash, history.max_size * sizeof(bitboard_t));
         }
-        if(history.board == NULL || history.move == NULL)
+        if(history.board == NULL || history.move == NULL || history.hash == NULL)
             quit("Error: Could not create history entry!\n");
 
         history.board[history.size] = *b;
         history.move[history.size] = m;
+        history.hash[history.size] = b->hash;
         history.size++;
     }
 }
@@ -94,6 +102,20 @@ move_t *peek_history_move(uint32_t pos) {
         return NULL;
 }
 
+/* Returns the hash of the board of an arbitrary position of the history stack
+ * (0 if there's none) */
+bitboard_t peek_history_hash(uint32_t pos) {
+    if(history.hash && history.size > pos)
+        return history.hash[pos];
+    else
+        return 0;
+}
+
+/* Returns the number of positions on the history stack */
+uint32_t peek_history_size(void) {
+    return history.board ? history.size : 0;
+}
+
 /* Returns the move of the top position of the history stack */
 move_t *peek_history_move_top(void) {
     if(history.move && history.size > 0)
@@ -37,6 +37,8 @@ definition, some constants and function prototypes.
 typedef struct {
     board_t *board; /* History list of boards */
     move_t *move; /* History list of moves*/
+    bitboard_t *hash; /* History list of the boards' hashes (compact, to look
+                       * for repetitions) */
     uint32_t size; /* Size (length) of the lists */
     uint32_t max_size; /* Maximum size of both lists */
 } history_t;
@@ -51,6 +53,8 @@ void push_history(board_t *b, move_t m);
 void pop_history(board_t *b);
 board_t *peek_history_board(uint32_t pos);
 move_t *peek_history_move(uint32_t pos);
+bitboard_t peek_history_hash(uint32_t pos);
 move_t *peek_history_move_top(void);
+uint32_t peek_history_size(void);
 
 #endif
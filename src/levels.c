@@ -36,222 +36,283 @@ static int num_levels;
 level_t *config;
 
 /* Loads the levels described in the levels' configuratino file
+ * The file is streamed, so each level is built as its elements are read.
  * If any sintax error is found, the program is aborted.
  */
 void load_levels() {
-    xml_node_t *root, **level, **aux;
-    char *attr;
-    int i;
+    level_loader_t loader;
 
-    root = xml_parser(LEVELS_CONFIG_FILE);
-    if(root->child_nodes == NULL || strcmp(root->child_nodes[0]->name, "chessdbot"))
-        quit("Error: Malformed levels configuration file!\n");
+    memset(&loader, 0, sizeof(level_loader_t));
+    xml_stream(LEVELS_CONFIG_FILE, level_tag_start, level_tag_end, NULL, &loader);
 
-    level = get_elements_by_tag_name(root, "level");
-    if(level == NULL)
+    if(num_levels == 0)
         quit("Error: Malformed levels configuration file!\n");
+}
 
-    for(num_levels = 0, aux = level; *aux; aux++, num_levels++);
-
-    levels = (level_t **) malloc(num_levels * sizeof(level_t *));
-    if(levels == NULL)
-        quit("Error: Could not load levels configuration file!\n");
-
-    for(i = 0; i < num_levels; i++) {
-        levels[i] = (level_t *) malloc(sizeof(level_t));
-        if(levels[i] == NULL)
-            quit("Error: Could not load levels configuration file!\n");
+/* Streaming handler for the starting tags of the levels' configuration file */
+void level_tag_start(void *data, const XML_Char *name, const XML_Char **attrs) {
+    level_loader_t *loader = (level_loader_t *) data;
+    char *attr;
 
-        attr = get_attribute(level[i], "name");
-        levels[i]->name = malloc((strlen(attr)+1) * sizeof(char));
-        if(levels[i]->name == NULL)
-            quit("Error: Could not load levels configuration file!\n");
-        strcpy(levels[i]->name, attr);
-        aux = get_elements_by_tag_name(level[i], "search");
-        if(aux == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        attr = get_attribute(*aux, "max_depth");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->max_depth = atoi(attr);
-        if(levels[i]->max_depth < 2)
-            quit("Error: max_depth must be at least 2\n");
-        attr = get_attribute(*aux, "max_seconds");
-        if(attr == NULL)
+    /* The root element must be 'chessdbot' */
+    if(loader->depth++ == 0) {
+        if(strcmp(name, "chessdbot"))
             quit("Error: Malformed levels configuration file!\n");
-        levels[i]->max_seconds = atoi(attr);
-        if(levels[i]->max_seconds < 1)
-            quit("Error: max_seconds must be at least 1\n");
-        free(aux);
+        return;
+    }
 
-        aux = get_elements_by_tag_name(level[i], "heuristic");
-        if(aux == NULL)
+    if(!strcmp(name, "level")) {
+        if(loader->level != NULL)
             quit("Error: Malformed levels configuration file!\n");
+        loader->level = (level_t *) malloc(sizeof(level_t));
+        if(loader->level == NULL)
+            quit("Error: Could not load levels configuration file!\n");
+        memset(loader->level, 0, sizeof(level_t));
+        loader->search = loader->heuristic = FALSE;
 
-        attr = get_attribute(*aux, "pawn_val");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->pawn_val = atoi(attr);
-        if(levels[i]->pawn_val < 0)
-            quit("Error: pawn_val must be at least 0\n");
-        attr = get_attribute(*aux, "bishop_val");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bishop_val = atoi(attr);
-        if(levels[i]->bishop_val < 0)
-            quit("Error: bishop_val must be at least 0\n");
-        attr = get_attribute(*aux, "knight_val");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->knight_val = atoi(attr);
-        if(levels[i]->knight_val < 0)
-            quit("Error: knight_val must be at least 0\n");
-        attr = get_attribute(*aux, "rook_val");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->rook_val = atoi(attr);
-        if(levels[i]->rook_val < 0)
-            quit("Error: rook_val must be at least 0\n");
-        attr = get_attribute(*aux, "queen_val");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->queen_val = atoi(attr);
-        if(levels[i]->queen_val < 0)
-            quit("Error: queen_val must be at least 0\n");
-        attr = get_attribute(*aux, "king_val");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->king_val = atoi(attr);
-        if(levels[i]->king_val < 0)
-            quit("Error: king_val must be at least 0\n");
-        attr = get_attribute(*aux, "factor_material");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->factor_material = atoi(attr);
-        if(levels[i]->factor_material < 0)
-            quit("Error: factor_material must be at least 0\n");
-        attr = get_attribute(*aux, "factor_development");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->factor_development = atoi(attr);
-        if(levels[i]->factor_development < 0)
-            quit("Error: factor_development must be at least 0\n");
-        attr = get_attribute(*aux, "factor_pawn");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->factor_pawn = atoi(attr);
-        if(levels[i]->factor_pawn < 0)
-            quit("Error: factor_pawn must be at least 0\n");
-        attr = get_attribute(*aux, "factor_bishop");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->factor_bishop = atoi(attr);
-        if(levels[i]->factor_bishop < 0)
-            quit("Error: factor_bishop must be at least 0\n");
-        attr = get_attribute(*aux, "factor_king");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->factor_king = atoi(attr);
-        if(levels[i]->factor_king < 0)
-            quit("Error: factor_king must be at least 0\n");
-        attr = get_attribute(*aux, "factor_knight");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        if(levels[i]->factor_knight < 0)
-            quit("Error: factor_knight must be at least 0\n");
-        levels[i]->factor_knight = atoi(attr);
-        attr = get_attribute(*aux, "factor_queen");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->factor_queen = atoi(attr);
-        if(levels[i]->factor_queen < 0)
-            quit("Error: factor_queen must be at least 0\n");
-        attr = get_attribute(*aux, "factor_rook");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->factor_rook = atoi(attr);
-        if(levels[i]->factor_rook < 0)
-            quit("Error: factor_rook must be at least 0\n");
-        attr = get_attribute(*aux, "bonus_early_queen_move");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_early_queen_move = atoi(attr);
-        attr = get_attribute(*aux, "bonus_early_bishop_stuck");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_early_bishop_stuck = atoi(attr);
-        attr = get_attribute(*aux, "bonus_early_knight_stuck");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_early_knight_stuck = atoi(attr);
-        attr = get_attribute(*aux, "bonus_has_castled");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_has_castled = atoi(attr);
-        attr = get_attribute(*aux, "bonus_hasnt_castled");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_hasnt_castled = atoi(attr);
-        attr = get_attribute(*aux, "bonus_passed_pawn");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_passed_pawn = atoi(attr);
-        attr = get_attribute(*aux, "bonus_isolated_pawn");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_isolated_pawn = atoi(attr);
-        attr = get_attribute(*aux, "bonus_backward_pawn");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_backward_pawn = atoi(attr);
-        attr = get_attribute(*aux, "bonus_doubled_pawn");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_doubled_pawn = atoi(attr);
-        attr = get_attribute(*aux, "bonus_tripled_pawn");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_tripled_pawn = atoi(attr);
-        attr = get_attribute(*aux, "bonus_doubled_bishop");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_doubled_bishop = atoi(attr);
-        attr = get_attribute(*aux, "bonus_fianchetto_bishop");
+        attr = get_stream_attribute(attrs, "name");
         if(attr == NULL)
             quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_fianchetto_bishop = atoi(attr);
-        attr = get_attribute(*aux, "bonus_knight_on_edge");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_knight_on_edge = atoi(attr);
-        attr = get_attribute(*aux, "bonus_knight_on_hole");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_knight_on_hole = atoi(attr);
-        attr = get_attribute(*aux, "bonus_rook_open_file");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_rook_open_file = atoi(attr);
-        attr = get_attribute(*aux, "bonus_rook_halfopen_file");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_rook_halfopen_file = atoi(attr);
-        attr = get_attribute(*aux, "bonus_queen_open_file");
-        if(attr == NULL)
-            quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_queen_open_file = atoi(attr);
-        attr = get_attribute(*aux, "bonus_queen_halfopen_file");
-        if(attr == NULL)
+        loader->level->name = malloc((strlen(attr)+1) * sizeof(char));
+        if(loader->level->name == NULL)
+            quit("Error: Could not load levels configuration file!\n");
+        strcpy(loader->level->name, attr);
+    } else if(!strcmp(name, "search")) {
+        if(loader->level == NULL)
             quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_queen_halfopen_file = atoi(attr);
-        attr = get_attribute(*aux, "bonus_center_control");
-        if(attr == NULL)
+        load_search_attributes(loader->level, attrs);
+        loader->search = TRUE;
+    } else if(!strcmp(name, "heuristic")) {
+        if(loader->level == NULL)
             quit("Error: Malformed levels configuration file!\n");
-        levels[i]->bonus_center_control = atoi(attr);
-        free(aux);
+        load_heuristic_attributes(loader->level, attrs);
+        loader->heuristic = TRUE;
+    }
+}
+
+/* Streaming handler for the ending tags of the levels' configuration file */
+void level_tag_end(void *data, const XML_Char *name) {
+    level_loader_t *loader = (level_loader_t *) data;
+
+    loader->depth--;
+
+    if(strcmp(name, "level") || loader->level == NULL)
+        return;
+
+    /* A level must have both its search and heuristic settings */
+    if(!loader->search || !loader->heuristic)
+        quit("Error: Malformed levels configuration file!\n");
+
+    /* Append the level just read to the list of levels */
+    levels = (level_t **) realloc(levels, (num_levels + 1) * sizeof(level_t *));
+    if(levels == NULL)
+        quit("Error: Could not load levels configuration file!\n");
+    levels[num_levels++] = loader->level;
+    loader->level = NULL;
+}
+
+/* Reads the attributes of a 'search' element into a level */
+void load_search_attributes(level_t *l, const XML_Char **attrs) {
+    char *attr;
+
+    attr = get_stream_attribute(attrs, "max_depth");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->max_depth = atoi(attr);
+    if(l->max_depth < 2)
+        quit("Error: max_depth must be at least 2\n");
+    attr = get_stream_attribute(attrs, "max_seconds");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->max_seconds = atoi(attr);
+    if(l->max_seconds < 1)
+        quit("Error: max_seconds must be at least 1\n");
+    /* The node budget makes the strength (and the CPU use) of a level the
+     * same on any host. Without one, only the depth and the time limit it */
+    attr = get_stream_attribute(attrs, "max_nodes");
+    if(attr == NULL) {
+        l->max_nodes = 0;
+    } else {
+        l->max_nodes = atoi(attr);
+        if(l->max_nodes < 0)
+            quit("Error: max_nodes must not be negative\n");
+    }
+    /* Without a scale of the late move reductions, the level gets one from
+     * its number */
+    attr = get_stream_attribute(attrs, "lmr_scale");
+    if(attr == NULL) {
+        l->lmr_scale = -1;
+    } else {
+        l->lmr_scale = atoi(attr);
+        if(l->lmr_scale < 0)
+            quit("Error: lmr_scale must not be negative\n");
     }
-    free(level);
-    clean_xml_node(root);
+}
+
+/* Reads the attributes of a 'heuristic' element into a level */
+void load_heuristic_attributes(level_t *l, const XML_Char **attrs) {
+    char *attr;
+
+    attr = get_stream_attribute(attrs, "pawn_val");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->pawn_val = atoi(attr);
+    if(l->pawn_val < 0)
+        quit("Error: pawn_val must be at least 0\n");
+    attr = get_stream_attribute(attrs, "bishop_val");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bishop_val = atoi(attr);
+    if(l->bishop_val < 0)
+        quit("Error: bishop_val must be at least 0\n");
+    attr = get_stream_attribute(attrs, "knight_val");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->knight_val = atoi(attr);
+    if(l->knight_val < 0)
+        quit("Error: knight_val must be at least 0\n");
+    attr = get_stream_attribute(attrs, "rook_val");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->rook_val = atoi(attr);
+    if(l->rook_val < 0)
+        quit("Error: rook_val must be at least 0\n");
+    attr = get_stream_attribute(attrs, "queen_val");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->queen_val = atoi(attr);
+    if(l->queen_val < 0)
+        quit("Error: queen_val must be at least 0\n");
+    attr = get_stream_attribute(attrs, "king_val");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->king_val = atoi(attr);
+    if(l->king_val < 0)
+        quit("Error: king_val must be at least 0\n");
+    attr = get_stream_attribute(attrs, "factor_material");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->factor_material = atoi(attr);
+    if(l->factor_material < 0)
+        quit("Error: factor_material must be at least 0\n");
+    attr = get_stream_attribute(attrs, "factor_development");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->factor_development = atoi(attr);
+    if(l->factor_development < 0)
+        quit("Error: factor_development must be at least 0\n");
+    attr = get_stream_attribute(attrs, "factor_pawn");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->factor_pawn = atoi(attr);
+    if(l->factor_pawn < 0)
+        quit("Error: factor_pawn must be at least 0\n");
+    attr = get_stream_attribute(attrs, "factor_bishop");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->factor_bishop = atoi(attr);
+    if(l->factor_bishop < 0)
+        quit("Error: factor_bishop must be at least 0\n");
+    attr = get_stream_attribute(attrs, "factor_king");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->factor_king = atoi(attr);
+    if(l->factor_king < 0)
+        quit("Error: factor_king must be at least 0\n");
+    attr = get_stream_attribute(attrs, "factor_knight");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->factor_knight = atoi(attr);
+    if(l->factor_knight < 0)
+        quit("Error: factor_knight must be at least 0\n");
+    attr = get_stream_attribute(attrs, "factor_queen");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->factor_queen = atoi(attr);
+    if(l->factor_queen < 0)
+        quit("Error: factor_queen must be at least 0\n");
+    attr = get_stream_attribute(attrs, "factor_rook");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->factor_rook = atoi(attr);
+    if(l->factor_rook < 0)
+        quit("Error: factor_rook must be at least 0\n");
+    attr = get_stream_attribute(attrs, "bonus_early_queen_move");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_early_queen_move = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_early_bishop_stuck");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_early_bishop_stuck = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_early_knight_stuck");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_early_knight_stuck = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_has_castled");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_has_castled = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_hasnt_castled");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_hasnt_castled = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_passed_pawn");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_passed_pawn = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_isolated_pawn");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_isolated_pawn = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_backward_pawn");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_backward_pawn = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_doubled_pawn");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_doubled_pawn = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_tripled_pawn");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_tripled_pawn = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_doubled_bishop");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_doubled_bishop = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_fianchetto_bishop");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_fianchetto_bishop = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_knight_on_edge");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_knight_on_edge = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_knight_on_hole");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_knight_on_hole = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_rook_open_file");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_rook_open_file = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_rook_halfopen_file");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_rook_halfopen_file = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_queen_open_file");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_queen_open_file = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_queen_halfopen_file");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_queen_halfopen_file = atoi(attr);
+    attr = get_stream_attribute(attrs, "bonus_center_control");
+    if(attr == NULL)
+        quit("Error: Malformed levels configuration file!\n");
+    l->bonus_center_control = atoi(attr);
 }
 
 void adjust_level(char *lvl){
@@ -262,6 +323,10 @@ void adjust_level(char *lvl){
 	printf("%d\n",config->max_depth);
     config->max_seconds = 2 + ((factor-9)/8);
 	printf("%d\n",config->max_seconds);
+    /* Late move reductions (in percent of the table) let the higher levels
+     * search deeper in the same time (unless the levels file sets them) */
+    if(config->lmr_scale < 0)
+        config->lmr_scale = factor;
 
     config->pawn_val = (factor+9)*-2/11+20;
 	printf("%d\n",config->pawn_val);
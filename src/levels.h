@@ -39,6 +39,8 @@ typedef struct {
     char *name;
     int max_depth;
     int max_seconds;
+    int max_nodes;
+    int lmr_scale;
     int pawn_val;
     int bishop_val;
     int knight_val;
@@ -74,12 +76,24 @@ typedef struct {
     int bonus_center_control;
 } level_t;
 
+/* State kept while streaming the levels' configuration file */
+typedef struct {
+    level_t *level; /* Level being read */
+    int depth;      /* Depth of the current element in the document */
+    bool search;    /* Has the level's 'search' element been read? */
+    bool heuristic; /* Has the level's 'heuristic' element been read? */
+} level_loader_t;
+
 /* The Global selected level configuration. */
 extern level_t *config;
 
 void validate_level(char *lvl);
 void adjust_level(char *lvl);
 void load_levels();
+void level_tag_start(void *data, const XML_Char *name, const XML_Char **attrs);
+void level_tag_end(void *data, const XML_Char *name);
+void load_search_attributes(level_t *l, const XML_Char **attrs);
+void load_heuristic_attributes(level_t *l, const XML_Char **attrs);
 void select_level(char *lvl);
 
 #endif
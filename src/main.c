@@ -29,8 +29,13 @@ Main module. Contains the Main function and some functions of general purpose.
 #include "cecp.h"
 #include "search.h"
 #include "levels.h"
+#include "bench.h"
 
 static char *level_name = NULL;
+/* Benchmark mode (see bench.c) */
+static bool bench_mode = FALSE;
+static uint8_t bench_depth = BENCH_DEPTH;
+static uint32_t bench_workers = BENCH_WORKERS;
 
 /* Condition and mutex used to sync Search & Cecp Threads
  * (see search.c and cecp.c) */
@@ -52,6 +57,9 @@ int main(int argc, char **argv) {
 
     /* Parse the command-line options */
     cmd_line_options(argc, argv);
+    /* The benchmark has a default level of its own */
+    if(bench_mode && level_name == NULL)
+        level_name = BENCH_LEVEL;
     /* Validates level typed in command line */
 
     validate_level(level_name);
@@ -60,6 +68,12 @@ int main(int argc, char **argv) {
     select_level("base_level");
     adjust_level(level_name);
 
+    /* In benchmark mode, there's no game: run it and leave */
+    if(bench_mode) {
+        bench(bench_depth, bench_workers);
+        return 0;
+    }
+
     /* Set Threads as joinable */
     pthread_attr_init(&atrib_threads);
     pthread_attr_setdetachstate(&atrib_threads, PTHREAD_CREATE_JOINABLE);
@@ -77,17 +91,35 @@ int main(int argc, char **argv) {
 
 /* Checks for command-line options */
 void cmd_line_options(int argc, char *argv[]) {
-    struct option opts[] = {{"level",1,0,'l'},{0,0,0,0}};
-    int opt;
+    struct option opts[] = {{"level",1,0,'l'},{"bench",0,0,'b'},{0,0,0,0}};
+    int opt, value;
 
-    while((opt = getopt_long(argc, argv, "l:", opts, NULL)) != -1) {
+    while((opt = getopt_long(argc, argv, "l:b", opts, NULL)) != -1) {
         switch(opt) {
         /* The option -l (or --level) selects a difficulty level */
         case 'l':
             level_name = strdup(optarg);
             break;
+        /* The option -b (or --bench) runs the benchmark, optionally
+         * followed by its depth and its number of workers */
+        case 'b':
+            bench_mode = TRUE;
+            break;
         }
     }
+
+    if(bench_mode && optind < argc) {
+        value = atoi(argv[optind++]);
+        if(value < 1 || value >= MAX_PLY)
+            quit("Error: Invalid benchmark depth!\n");
+        bench_depth = value;
+    }
+    if(bench_mode && optind < argc) {
+        value = atoi(argv[optind++]);
+        if(value < 1)
+            quit("Error: Invalid number of benchmark workers!\n");
+        bench_workers = value;
+    }
 }
 
 /* Quit function. Aborts program while prints an error message */
@@ -40,10 +40,15 @@ software.
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <signal.h>
 #include <getopt.h>
 
+/* A function with an instance for each value of a parameter known at compile
+ * time (e.g. the color on move), expanded into the callers that dispatch on it */
+#define SPECIALIZED static inline __attribute__((always_inline))
+
 #define MAX(x,y) ((x)>(y)?(x):(y))
 #define MIN(x,y) ((x)<(y)?(x):(y))
 
@@ -28,11 +28,7 @@ Movements module. Contains the functions that generate all the possible moves
 * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 #include "moves.h"
 #include "history.h"
-
-/* Boards used in knight's and king's move generation */
-bitboard_t moves_knight[8][8], moves_king[8][8];
-/* Rows used in rook's, bishop's and queen's move generation */
-bitline_t moves_slide[8][256];
+#include "see.h"
 
 /* Creates a move list.
  * Return a new empty move list. NULL is returned if an error occur */
@@ -91,30 +87,31 @@ void clear_move_list(move_list_t *list) {
 
 /* Generate a legal move list */
 move_list_t *gen_move_list(board_t *b, bool captures_only) {
-    uint8_t i, onmove = b->onmove;
+    uint8_t i;
     move_list_t *illegal, *legal;
 
     /* Initialize the list of all possible moves (including illegal ones) */
     illegal = init_move_list();
 
-    /* Generate all the moves, for each kind of piece */
-    gen_pawn(b, illegal, captures_only);
-    gen_bishop(b, illegal, captures_only);
-    gen_knight(b, illegal, captures_only);
-    gen_rook(b, illegal, captures_only);
-    gen_queen(b, illegal, captures_only);
-    gen_king(b, illegal, captures_only);
+    /* In check, only the moves that may get out of it */
+    if(b->checkers) {
+        gen_evasions(b, illegal, captures_only);
+    /* Otherwise, generate all the moves, for each kind of piece */
+    } else {
+        gen_pawn(b, illegal, captures_only);
+        gen_bishop(b, illegal, captures_only);
+        gen_knight(b, illegal, captures_only);
+        gen_rook(b, illegal, captures_only);
+        gen_queen(b, illegal, captures_only);
+        gen_king(b, illegal, captures_only);
+    }
 
     /* Start a list of all the legal moves */
     legal = init_move_list();
     /* For each move on the illegal list, check if it is legal */
-    for(i = 0; i < illegal->size; i++) {
-        move(b, illegal->move[i]);
-        /* If the move doesn't leave us in check, add it to the legal list */
-        if(!check(b, b->bitboard[onmove][KING], !onmove))
+    for(i = 0; i < illegal->size; i++)
+        if(legal_move(b, illegal->move[i]))
             add_move(legal, illegal->move[i]);
-        unmove(b);
-    }
 
     /* Clear the illegal move list */
     clear_move_list(illegal);
@@ -122,9 +119,99 @@ move_list_t *gen_move_list(board_t *b, bool captures_only) {
     return legal;
 }
 
-/* Generate pawn's moves and add them to a move list */
-void gen_pawn(board_t *b, move_list_t *list, bool captures_only) {
-    int8_t src, src_y, src_x, dst, dst_y, dst_x, onmove = b->onmove, i, j;
+/* Check if a move from the generators (that may leave its own king in check)
+ * is legal. Only the moves of the king, of the pinned pieces and en passant
+ * (that takes two pieces off a line) can expose the king and have to be
+ * tried: any other generated move is legal (in check, the generators only
+ * give the evasions) */
+bool legal_move(board_t *b, move_t m) {
+    uint8_t onmove = b->onmove;
+    bool legal;
+
+    if(!GET_BIT(b->bitboard[onmove][KING] | b->pinned, m.src_y, m.src_x) && !enpassant_move(b, m))
+        return TRUE;
+
+    /* If the move doesn't leave us in check, it's legal */
+    move(b, m);
+    legal = !check(b, b->bitboard[onmove][KING], !onmove);
+    unmove(b);
+    return legal;
+}
+
+/* Check if a move is an en passant capture */
+bool enpassant_move(board_t *b, move_t m) {
+    return ENPASSANT_GET_VALID(b->enpassant) && m.dst_x == ENPASSANT_GET_FILE(b->enpassant) && m.dst_y == (b->onmove ? RANK_6 : RANK_3) &&
+           GET_BIT(b->bitboard[b->onmove][PAWN], m.src_y, m.src_x);
+}
+
+/* Check if the side on move has any legal move, trying them one kind of piece
+ * at a time until the first legal one (cheaper than the whole list) */
+bool has_legal_move(board_t *b) {
+    static void (*gen[])(board_t *, move_list_t *, bool) = {gen_pawn, gen_knight, gen_bishop, gen_rook, gen_queen, gen_king};
+    uint32_t i, j;
+    move_list_t *list;
+    bool legal = FALSE;
+
+    list = init_move_list();
+    for(i = 0; !legal && i < (b->checkers ? 1 : sizeof(gen) / sizeof(gen[0])); i++) {
+        /* In check, all the evasions at once */
+        list->size = 0;
+        if(b->checkers)
+            gen_evasions(b, list, FALSE);
+        else
+            gen[i](b, list, FALSE);
+        for(j = 0; j < list->size && !legal; j++)
+            legal = legal_move(b, list->move[j]);
+    }
+
+    clear_move_list(list);
+    return legal;
+}
+
+/* Generate the moves that may get the side on move out of check: the king
+ * moves, and with a single checker, the moves that capture it or block its
+ * ray. The others can't be legal, and never get to be tried */
+void gen_evasions(board_t *b, move_list_t *list, bool captures_only) {
+    uint32_t i, j;
+    int8_t onmove = b->onmove, king, checker, y, x, dy, dx;
+    bitboard_t target = b->checkers;
+
+    /* In a double check, only the king can move */
+    if(target & (target - 1)) {
+        gen_king(b, list, captures_only);
+        return;
+    }
+
+    /* A sliding checker can be blocked on the squares between it and the king */
+    if(!(target & (b->bitboard[!onmove][KNIGHT] | b->bitboard[!onmove][PAWN]))) {
+        king = FIRST_BIT(b->bitboard[onmove][KING]);
+        checker = FIRST_BIT(target);
+        dy = (checker/8 > king/8) - (checker/8 < king/8);
+        dx = (checker%8 > king%8) - (checker%8 < king%8);
+        for(y = king/8 + dy, x = king%8 + dx; y != checker/8 || x != checker%8; y += dy, x += dx)
+            SET_BIT(target, y, x);
+    }
+
+    /* Keep only the moves of the other pieces that land on the target (or
+     * capture en passant a pawn that gives check) */
+    j = list->size;
+    gen_pawn(b, list, captures_only);
+    gen_bishop(b, list, captures_only);
+    gen_knight(b, list, captures_only);
+    gen_rook(b, list, captures_only);
+    gen_queen(b, list, captures_only);
+    for(i = j; i < list->size; i++)
+        if(GET_BIT(target, list->move[i].dst_y, list->move[i].dst_x) ||
+           ((b->checkers & b->bitboard[!onmove][PAWN]) && enpassant_move(b, list->move[i])))
+            list->move[j++] = list->move[i];
+    list->size = j;
+
+    gen_king(b, list, captures_only);
+}
+
+/* Generate pawn's moves and add them to a move list, for a given color */
+SPECIALIZED void gen_pawn_color(board_t *b, move_list_t *list, bool captures_only, const uint8_t onmove) {
+    int8_t src, src_y, src_x, dst, dst_y, dst_x, i, j;
     bitboard_t from = b->bitboard[onmove][PAWN], to;
 
     /* Capture moves */
@@ -161,9 +248,17 @@ void gen_pawn(board_t *b, move_list_t *list, bool captures_only) {
             add_move(list, gen_move(src_y, src_x, dst_y, dst_x, NO_PROMOTION));
     }
 
-    /* If we are generating only the capture moves, get out */
-    if(captures_only)
+    /* If we are generating only the capture moves, add the promotions to a
+     * queen (they change the material as much as a capture) and get out */
+    if(captures_only) {
+        to = onmove ? (((from & rank[RANK_7]) << 8) & ~(b->rotation[COLORS][ROT_0])) : (((from & rank[RANK_2]) >> 8) & ~(b->rotation[COLORS][ROT_0]));
+        for(; (dst = FIRST_BIT(to)) != -1; CLEAR_BIT(to, dst_y, dst_x)) {
+            dst_y = dst/8;
+            dst_x = dst%8;
+            add_move(list, gen_move((onmove ? RANK_7 : RANK_2), dst_x, dst_y, dst_x, QUEEN));
+        }
         return;
+    }
 
     /* Single moves */
     to = onmove ? ((from << 8) & ~(b->rotation[COLORS][ROT_0])) : ((from >> 8) & ~(b->rotation[COLORS][ROT_0]));
@@ -208,6 +303,14 @@ void gen_pawn(board_t *b, move_list_t *list, bool captures_only) {
 
 }
 
+/* Generate pawn's moves and add them to a move list */
+void gen_pawn(board_t *b, move_list_t *list, bool captures_only) {
+    if(b->onmove == COLOR_WHITE)
+        gen_pawn_color(b, list, captures_only, COLOR_WHITE);
+    else
+        gen_pawn_color(b, list, captures_only, COLOR_BLACK);
+}
+
 /* Generate knight's moves and add them to a move list */
 void gen_knight(board_t *b, move_list_t *list, bool captures_only) {
     int8_t src, src_y, src_x, dst, dst_y, dst_x, onmove = b->onmove;
@@ -350,12 +453,12 @@ void gen_queen(board_t *b, move_list_t *list, bool captures_only) {
     }
 }
 
-/* Generate king's moves and add them to a move list */
-void gen_king(board_t *b, move_list_t *list, bool captures_only) {
+/* Generate king's moves and add them to a move list, for a given color */
+SPECIALIZED void gen_king_color(board_t *b, move_list_t *list, bool captures_only, const uint8_t onmove) {
     /* Squares used in king's move generation */
     static bitboard_t check_squares[COLORS][CASTLE_SIDES]  = {{0x3800000000000000ULL,0x0E00000000000000ULL},{0x0000000000000038ULL,0x000000000000000EULL}},
               free_squares[COLORS][CASTLE_SIDES] = {{0x7000000000000000ULL,0x0600000000000000ULL},{0x0000000000000070ULL,0x0000000000000006ULL}};
-    int8_t src, src_y, src_x, dst, dst_y, dst_x, onmove = b->onmove, side;
+    int8_t src, src_y, src_x, dst, dst_y, dst_x, side;
     bitboard_t from = b->bitboard[onmove][KING], to;
 
     /* Castle moves */
@@ -384,11 +487,19 @@ void gen_king(board_t *b, move_list_t *list, bool captures_only) {
     }
 }
 
+/* Generate king's moves and add them to a move list */
+void gen_king(board_t *b, move_list_t *list, bool captures_only) {
+    if(b->onmove == COLOR_WHITE)
+        gen_king_color(b, list, captures_only, COLOR_WHITE);
+    else
+        gen_king_color(b, list, captures_only, COLOR_BLACK);
+}
+
 
 /* Return a well-formed move structure, with the given parameters into it */
 move_t gen_move(uint8_t src_y, uint8_t src_x, uint8_t dst_y, uint8_t dst_x, uint8_t promo) {
     move_t m;
-    memset(&m, 0, sizeof(move_t));
+    SET_BLANK_MOVE(m);
     m.src_y = src_y;
     m.src_x = src_x;
     m.dst_y = dst_y;
@@ -397,43 +508,108 @@ move_t gen_move(uint8_t src_y, uint8_t src_x, uint8_t dst_y, uint8_t dst_x, uint
     return m;
 }
 
-/* Reorders a move list, letting the best captures first */
-void reorder_move_list(board_t *b, move_list_t *list) {
-    static uint8_t piece_value[] = {1, 3, 5, 5, 9, 100};
-    int8_t piece, attacker = -1, victim = -1, i, j, max;
-    move_t swap;
+/* Returns the piece on a given square of a given color, or -1 if empty */
+int8_t piece_at(board_t *b, uint8_t color, uint8_t y, uint8_t x) {
+    int8_t piece;
+
+    for(piece = PAWN; piece < PIECES; piece++)
+        if(GET_BIT(b->bitboard[color][piece], y, x))
+            return piece;
+    return -1;
+}
+
+/* Returns the piece captured by a move, or -1 if it isn't a capture */
+int8_t captured_piece(board_t *b, move_t m) {
+    int8_t victim = piece_at(b, !b->onmove, m.dst_y, m.dst_x);
+
+    /* An en-passant capture lands on an empty square */
+    if(victim == -1 && ENPASSANT_GET_VALID(b->enpassant) && m.dst_x == ENPASSANT_GET_FILE(b->enpassant)
+       && m.dst_y == (b->onmove ? RANK_6 : RANK_3) && GET_BIT(b->bitboard[b->onmove][PAWN], m.src_y, m.src_x))
+        victim = PAWN;
+    return victim;
+}
+
+/* Returns TRUE if a capture loses material, according to the Static Exchange
+ * Evaluation. Taking a piece at least as valuable as ours never loses */
+bool losing_capture(board_t *b, move_t m) {
+    int8_t attacker = piece_at(b, b->onmove, m.src_y, m.src_x), victim = captured_piece(b, m);
+
+    if(attacker == -1 || victim == -1 || exchange_value[attacker] <= exchange_value[victim])
+        return FALSE;
+    return see(b, m) < 0;
+}
+
+/* Set the ordering score of the captures (and promotions) of a move list.
+ * Captures follow the MVV/LVA rule (Most Valuable Victim/Least Valuable
+ * Attacker), but the ones that lose material (SEE) come after the others.
+ * Other moves score zero */
+void score_captures(board_t *b, move_list_t *list, int32_t *score) {
+    int8_t attacker, victim;
+    uint32_t i;
 
-    /* Set the moves' evaluation, following the MVV/LVA rule
-     * (Most Valuable Victim/Least Valuable Attacker) */
     for(i = 0; i < list->size; i++) {
-        for(piece = PAWN; piece < PIECES; piece++) {
-            if(GET_BIT(b->bitboard[piece][b->onmove], list->move[i].src_y, list->move[i].src_x))
-                attacker = piece;
-            if(GET_BIT(b->bitboard[piece][b->onmove], list->move[i].dst_y, list->move[i].dst_x))
-                victim = piece;
-        }
-        /* If it's really a capture move, set the evaluation */
-        if(attacker != -1 && victim != -1)
-            list->move[i].eval = piece_value[attacker] / piece_value[victim];
-        else
-            return;
+        attacker = piece_at(b, b->onmove, list->move[i].src_y, list->move[i].src_x);
+        victim = captured_piece(b, list->move[i]);
+        score[i] = 0;
+        if(victim != -1)
+            score[i] += losing_capture(b, list->move[i]) ? LOSING_CAPTURE : MVV_LVA(exchange_value[victim], exchange_value[attacker]);
+        if(list->move[i].promotion != NO_PROMOTION)
+            score[i] += MVV_LVA(exchange_value[list->move[i].promotion] - exchange_value[PAWN], 0);
     }
+}
 
-    /* Order the move list */
-    for(i = 0; i < list->size; i++) {
-        max = i;
-        for(j = i+1; j < list->size; j++)
-            if(list->move[j].eval > list->move[max].eval)
-                max = j;
+/* Order a move list by the moves' scores, the highest first (insertion sort,
+ * keeping the order of the moves with the same score) */
+void sort_move_list(move_list_t *list, int32_t *score) {
+    int32_t i, j, swap_score;
+    move_t swap;
+
+    for(i = 1; i < list->size; i++) {
         swap = list->move[i];
-        list->move[i] = list->move[max];
-        list->move[max] = swap;
+        swap_score = score[i];
+        for(j = i - 1; j >= 0 && score[j] < swap_score; j--) {
+            list->move[j + 1] = list->move[j];
+            score[j + 1] = score[j];
+        }
+        list->move[j + 1] = swap;
+        score[j + 1] = swap_score;
     }
 }
 
-/* Perform a given move on a given board, even if it's an invalid move */
-void move(board_t *b, move_t m) {
-    uint8_t piece, onmove = b->onmove, rot;
+/* Swap two moves of a move list, with their scores */
+void swap_moves(move_list_t *list, int32_t *score, uint32_t i, uint32_t j) {
+    move_t m = list->move[i];
+    int32_t s = score[i];
+
+    list->move[i] = list->move[j];
+    score[i] = score[j];
+    list->move[j] = m;
+    score[j] = s;
+}
+
+/* Move the i-th move of a move list (with its score) to the front, keeping
+ * the order of the others */
+void first_move(move_list_t *list, int32_t *score, uint32_t i) {
+    move_t m = list->move[i];
+    int32_t s = score[i];
+
+    memmove(&list->move[1], &list->move[0], i * sizeof(move_t));
+    memmove(&score[1], &score[0], i * sizeof(int32_t));
+    list->move[0] = m;
+    score[0] = s;
+}
+
+/* Reorders a move list, letting the best captures (and promotions) first.
+ * Other moves keep their order, after the captures */
+void reorder_move_list(board_t *b, move_list_t *list, int32_t *score) {
+    score_captures(b, list, score);
+    sort_move_list(list, score);
+}
+
+/* Perform a given move on a given board, even if it's an invalid move, for a
+ * given color on move */
+SPECIALIZED void move_color(board_t *b, move_t m, const uint8_t onmove) {
+    uint8_t piece, rot;
     bool capture = FALSE;
 
     /* Save current state */
@@ -566,6 +742,17 @@ void move(board_t *b, move_t m) {
     /* Update rotated bitboards */
     for(rot = ROT_0; rot < ROTATIONS; rot++)
         b->rotation[COLORS][rot] = b->rotation[COLOR_BLACK][rot] | b->rotation[COLOR_WHITE][rot];
+
+    /* Is the new side on move in check? */
+    update_checks(b);
+}
+
+/* Perform a given move on a given board, even if it's an invalid move */
+void move(board_t *b, move_t m) {
+    if(b->onmove == COLOR_WHITE)
+        move_color(b, m, COLOR_WHITE);
+    else
+        move_color(b, m, COLOR_BLACK);
 }
 
 /* Restore previous state */
@@ -573,12 +760,45 @@ void unmove(board_t *b) {
     pop_history(b);
 }
 
+/* Null move: the side on move passes its turn. The en passant right is lost,
+ * and the half-moves count starts over. It's saved in the history as a blank
+ * move */
+void move_null(board_t *b) {
+    move_t m;
+
+    SET_BLANK_MOVE(m);
+    push_history(b, m);
+
+    b->hash ^= zobrist_enpassant[b->enpassant];
+    ENPASSANT_SET_VALID(b->enpassant, FALSE);
+    ENPASSANT_SET_FILE(b->enpassant, 0);
+    b->hash ^= zobrist_enpassant[b->enpassant];
+
+    /* Nothing before a null move can be repeated after it (the search of the
+     * repetitions stops at the last irreversible move) */
+    b->hm = 0;
+    if(b->onmove == COLOR_BLACK)
+        b->fm++;
+
+    b->onmove = !b->onmove;
+    b->hash ^= zobrist_white_onmove;
+
+    /* The checks and pins of the new side on move */
+    update_checks(b);
+}
+
+/* Take a null move back */
+void unmove_null(board_t *b) {
+    pop_history(b);
+}
+
 /* Translate moves in Coordinate notation to internal move structure format */
 bool coord_to_move(char *c, move_t *m) {
     uint8_t len;
 
     if(c == NULL || m == NULL)
         return FALSE;
+    SET_BLANK_MOVE(*m);
 
     /* Check valid coord length */
     /* i.e. d2d4, f6a1, e1g1, b7b8q, h7h8n */
@@ -663,6 +883,7 @@ bool san_to_move(board_t *b, char *s, move_t *m) {
 
     if(b == NULL || s == NULL || m == NULL)
         return FALSE;
+    SET_BLANK_MOVE(*m);
 
     /* In case it's a castle move */
     if(!strncmp(s, "O-O", 3)) {
@@ -847,73 +1068,6 @@ bool san_to_move(board_t *b, char *s, move_t *m) {
     return TRUE;
 }
 
-/* Generate move tables used extensively by move generation */
-void precompute_moves(void) {
-    uint8_t x, y;
-    int16_t line, i, j;
-
-    /* Knight moves */
-    for(y = 0; y < 8; y++)
-        for(x = 0; x < 8; x++) {
-            moves_knight[y][x] = 0;
-            if(y-2 >= 0 && x-1 >= 0)
-                SET_BIT(moves_knight[y][x],y-2,x-1);
-            if(y-2 >= 0 && x+1 <= 7)
-                SET_BIT(moves_knight[y][x],y-2,x+1);
-            if(y-1 >= 0 && x-2 >= 0)
-                SET_BIT(moves_knight[y][x],y-1,x-2);
-            if(y-1 >= 0 && x+2 <= 7)
-                SET_BIT(moves_knight[y][x],y-1,x+2);
-            if(y+1 <= 7 && x-2 >= 0)
-                SET_BIT(moves_knight[y][x],y+1,x-2);
-            if(y+1 <= 7 && x+2 <= 7)
-                SET_BIT(moves_knight[y][x],y+1,x+2);
-            if(y+2 <= 7 && x-1 >= 0)
-                SET_BIT(moves_knight[y][x],y+2,x-1);
-            if(y+2 <= 7 && x+1 <= 7)
-                SET_BIT(moves_knight[y][x],y+2,x+1);
-        }
-
-    /* King moves */
-    for(y = 0; y < 8; y++)
-        for(x = 0; x < 8; x++) {
-            moves_king[y][x] = 0;
-            if(y-1 >= 0 && x-1 >= 0)
-                SET_BIT(moves_king[y][x],y-1,x-1);
-            if(y-1 >= 0)
-                SET_BIT(moves_king[y][x],y-1,x);
-            if(y-1 >= 0 && x+1 <= 7)
-                SET_BIT(moves_king[y][x],y-1,x+1);
-            if(x-1 >= 0)
-                SET_BIT(moves_king[y][x],y,x-1);
-            if(x+1 <= 7)
-                SET_BIT(moves_king[y][x],y,x+1);
-            if(y+1 <= 7 && x-1 >= 0)
-                SET_BIT(moves_king[y][x],y+1,x-1);
-            if(y+1 <= 7)
-                SET_BIT(moves_king[y][x],y+1,x);
-            if(y+1 <= 7 && x+1 <= 7)
-                SET_BIT(moves_king[y][x],y+1,x+1);
-        }
-
-    /* Slide moves (Rook, Bishop & Queen) */
-    for(j = 0; j < 8; j++)
-        for(line = 0; line < 256; line++) {
-            moves_slide[j][line] = 0;
-            for(i = 1; j+i < 8; i++) {
-                SET_BIT(moves_slide[j][line],0,j+i);
-                if(GET_BIT(line,0,j+i))
-                    break;
-        }
-            for(i = 1; j-i >= 0; i++) {
-                SET_BIT(moves_slide[j][line],0,j-i);
-                if(GET_BIT(line,0,j-i))
-                    break;
-            }
-        }
-}
-
-
 /* Check if a movement is valid, given a board */
 bool check_valid_move(board_t *b, move_t m) {
     move_list_t *legal = NULL;
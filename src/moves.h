@@ -32,24 +32,42 @@ function prototypes.
 #include "main.h"
 #include "board.h"
 
-/* Movement structure */
-typedef struct {
-    uint16_t src_y : 3; /* Source rank */
-    uint16_t src_x : 3; /* Source file */
-    uint16_t dst_y : 3; /* Destination rank */
-    uint16_t dst_x : 3; /* Destination file */
-    uint16_t promotion : 3; /* No promotion + 4 pieces = 5 states */
-    uint16_t fill : 1; /* unnused, just to fit in 16 bits */
-    int32_t eval; /* Movement (heuristic) evaluation */
-} move_t; /* 6 bytes */
+/* Movement structure. Its fields fit in 16 bits, that can be handled at once
+ * (the unused one must be zero). Scores are kept apart (see move_list_t) */
+typedef union {
+    struct {
+        uint16_t src_y : 3; /* Source rank */
+        uint16_t src_x : 3; /* Source file */
+        uint16_t dst_y : 3; /* Destination rank */
+        uint16_t dst_x : 3; /* Destination file */
+        uint16_t promotion : 3; /* No promotion + 4 pieces = 5 states */
+        uint16_t fill : 1; /* unnused, just to fit in 16 bits */
+    };
+    uint16_t bits; /* All the fields at once */
+} move_t; /* 2 bytes */
 
 /* Movements manipulation macros */
-#define SET_BLANK_MOVE(m) memset(&m, 0, sizeof(move_t))
-#define IS_BLANK_MOVE(m) (((m).dst_x == 0) && ((m).dst_y == 0) && ((m).src_x == 0) && ((m).src_y == 0) && ((m).promotion == 0) && ((m).eval == 0))
+#define SET_BLANK_MOVE(m) ((m).bits = 0)
+#define SAME_MOVE(a,b) ((a).bits == (b).bits)
+#define IS_BLANK_MOVE(m) ((m).bits == 0)
+
+/* Move ordering scores. Good captures come first (valuable victims first,
+ * then cheaper attackers), then the killer moves and the countermove, then
+ * the captures that lose material, and the other quiet moves at last, in the
+ * order of their history score (below LOSING_CAPTURE) */
+#define MVV_LVA(victim,attacker) (GOOD_CAPTURE + (victim) * 128 + 128 - (attacker))
+#define GOOD_CAPTURE 0x1000000
+#define KILLER_MOVE 0x800000
+#define COUNTER_MOVE 0x400000
+#define LOSING_CAPTURE 0x200000
 
 /* Minimum size of a move list and also the increase size when a list is full */
 #define MOVE_LIST_PAGE_SIZE 32
 
+/* Most legal moves of a position (218 is the most known): the size of the
+ * ordering scores of a list, kept apart by the search */
+#define MAX_MOVES 256
+
 /* Move List structure */
 typedef struct {
     move_t *move; /* List of movements */
@@ -57,15 +75,20 @@ typedef struct {
     uint32_t max_size; /* Maximum size of the list */
 } move_list_t;
 
-/* Move tables for knights, kings and sliding pieces (queen, rook and bishop) */
-extern bitboard_t moves_knight[8][8], moves_king[8][8];
-extern bitline_t moves_slide[8][256];
+/* Move tables for knights, kings and sliding pieces (queen, rook and bishop),
+ * generated at build time (see tablegen.c) */
+extern const bitboard_t moves_knight[8][8], moves_king[8][8];
+extern const bitline_t moves_slide[8][256];
 
 /* Function prototypes */
 move_list_t *init_move_list(void);
 void add_move(move_list_t *l, move_t m);
 void clear_move_list(move_list_t *list);
 move_list_t *gen_move_list(board_t *b, bool captures_only);
+bool legal_move(board_t *b, move_t m);
+bool enpassant_move(board_t *b, move_t m);
+bool has_legal_move(board_t *b);
+void gen_evasions(board_t *b, move_list_t *list, bool captures_only);
 void gen_pawn(board_t *b, move_list_t *list, bool captures_only);
 void gen_knight(board_t *b, move_list_t *list, bool captures_only);
 void gen_bishop(board_t *b, move_list_t *list, bool captures_only);
@@ -73,11 +96,20 @@ void gen_rook(board_t *b, move_list_t *list, bool captures_only);
 void gen_queen(board_t *b, move_list_t *list, bool captures_only);
 void gen_king(board_t *b, move_list_t *list, bool captures_only);
 move_t gen_move(uint8_t src_y, uint8_t src_x, uint8_t dst_y, uint8_t dst_x, uint8_t promo);
+int8_t piece_at(board_t *b, uint8_t color, uint8_t y, uint8_t x);
+int8_t captured_piece(board_t *b, move_t m);
+bool losing_capture(board_t *b, move_t m);
+void score_captures(board_t *b, move_list_t *list, int32_t *score);
+void sort_move_list(move_list_t *list, int32_t *score);
+void swap_moves(move_list_t *list, int32_t *score, uint32_t i, uint32_t j);
+void first_move(move_list_t *list, int32_t *score, uint32_t i);
+void reorder_move_list(board_t *b, move_list_t *list, int32_t *score);
 void move(board_t *b, move_t m);
 void unmove(board_t *b);
+void move_null(board_t *b);
+void unmove_null(board_t *b);
 bool coord_to_move(char *c, move_t *m);
 bool move_to_coord(char *c, move_t *m);
 bool san_to_move(board_t *b, char *s, move_t *m);
-void precompute_moves(void);
 bool check_valid_move(board_t *b, move_t m);
 #endif
@@ -31,12 +31,15 @@ user. Basically it recieves commands from the CECP Thread, and after performing
 the search, returns an answer (a chess movement).
 
 * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <math.h>
 #include "search.h"
 #include "heuristic.h"
 #include "transposition.h"
 #include "eco.h"
 #include "history.h"
 #include "levels.h"
+#include "timeman.h"
+#include "cecp.h"
 
 /* Main board structure, shared with CECP Thread */
 board_t *board;
@@ -48,30 +51,90 @@ static bool timeout = FALSE;
 static pthread_mutex_t timeout_mutex = PTHREAD_MUTEX_INITIALIZER;
 static struct timeval alarm_clock = {ALARM_INIT_SEC, ALARM_INIT_USEC};
 
-/* Used to hold whose color is on move during a search process */
-static uint8_t onmove;
-
 /* Maximum depth of the Minimax search tree */
 uint8_t max_depth;
+/* Maximum nodes visited by a search on our own time (0 for no limit) */
+uint64_t max_nodes;
+/* Node count that stops the current search (0 for no limit) */
+static uint64_t node_limit = 0;
 
-/* Search thread main function */
-void *search_loop(void *arg) {
-    uint8_t ply;
-    move_t mv, mv_tmp;
+/* Print thinking output (set by 'post' and 'nopost' commands) */
+bool post = FALSE;
+/* Statistics of the current search */
+static stats_t stats;
+/* Time when the current search has started */
+static struct timeval start_time;
 
-    SET_BLANK_MOVE(mv);
-    SET_BLANK_MOVE(mv_tmp);
+/* Triangular array of the best lines found at each height of the search */
+static move_t pv_line[MAX_PLY][MAX_PLY];
+static uint8_t pv_length[MAX_PLY];
+/* Principal variation of the last complete iteration */
+static pv_t pv;
+/* Are we still on the previous principal variation? */
+static bool follow_pv;
+/* Best move found by the current iteration at the root, up to now, and its
+ * score */
+static move_t root_move;
+static int32_t root_eval;
+/* That move and score have already been printed (by an analysis, as soon as
+ * it was found) */
+static bool root_shown;
+/* Best move of the last search of the root (even if it failed low or high) */
+static move_t root_best;
+/* Best lines of the last iteration, the best first (more than one in a
+ * Multi-PV search) */
+static pv_t lines[MAX_MULTI_PV];
+static uint8_t lines_size = 0;
+/* Root moves left out of the search: the first ones of the lines already
+ * found in the current iteration */
+static uint8_t excluded_size = 0;
+
+/* Height of the node whose null move cutoff is being verified (no null move
+ * is tried there) */
+static uint8_t verify_height = MAX_PLY;
+
+/* Futility margins (by depth left) and razoring margin of the level: the
+ * most a quiet move is expected to change the evaluation. Zero disables them */
+static int32_t futility_margin[FUTILITY_MAX_PLY + 1];
+static int32_t razor_margin;
+
+/* Scale of the late move reductions of the level, in percent of the table */
+static int32_t lmr_scale;
 
+/* Number of best lines to search for (set by the 'MultiPV' option) */
+uint8_t multi_pv = 1;
+
+/* Time limits of the current search (microseconds since it has started) */
+static uint64_t soft_limit, hard_limit;
+/* The current search has no time limit (it's on the opponent's time, or an
+ * analysis) */
+static bool infinite = FALSE;
+/* The current search is an analysis: it prints every change of its line */
+static bool analyzing = FALSE;
+/* The search thread is searching (with the expected move on the board, if
+ * it's pondering). While so, the board belongs to it */
+static bool searching = FALSE;
+/* Opponent's move expected while pondering, and the board after it */
+static move_t ponder_move;
+static board_t ponder_board;
+/* Think on the opponent's time (set by 'hard' and 'easy' commands) */
+bool ponder_enabled = FALSE;
+/* The opponent has offered a draw, to be judged before our next move */
+static bool draw_offered = FALSE;
+
+/* Killer moves: the last quiet moves that caused a beta cutoff at each height */
+static move_t killers[MAX_PLY][KILLERS];
+/* History heuristic: how often each quiet move (of each color, from each
+ * square to each square) has caused a beta cutoff, weighted by depth */
+static int32_t history_score[COLORS][64][64];
+/* Countermoves: the last quiet move that refuted each opponent's move */
+static move_t countermoves[64][64];
+
+/* Search thread main function */
+void *search_loop(void *arg) {
     pthread_mutex_lock(&mutex);
 
-    /* Initializations */
-    precompute_moves();
-    precompute_distances();
-    init_zobrist_keys();
-    init_history();
-    init_transposition_table();
-    config_alarm(config->max_seconds);
-    max_depth = config->max_depth;
+    init_search();
 
     /* Setup board */
     board = set_board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
@@ -84,6 +147,8 @@ void *search_loop(void *arg) {
         if(!load_eco(board))
             quit("Error: Could not load Encyclopedia of Chess Openings!\n");
 
+    /* The CECP Thread may use the board from now on */
+    pthread_cond_broadcast(&cond);
     pthread_mutex_unlock(&mutex);
  
     /* Keep alive until the status changes to QUIT */
@@ -104,34 +169,16 @@ void *search_loop(void *arg) {
     	    pthread_mutex_unlock(&mutex);
     	    break;
     	case SEARCH:
-    	    /* Iterative Deepening Search */
-    	    /* Save the on-move color */
-    	    onmove = board->onmove;
-    	    /* Sets as blank the move to be played*/
-    	    SET_BLANK_MOVE(mv);
-    	    /* Starts counting the time */
-    	    start_alarm();
-    	    /* For each depth, search with alpha-beta minimax */
-    	    for(ply = 2; ply <= max_depth; ply += 2) {
-    	    	mv_tmp = alpha_beta(board, -MAX_HEU, MAX_HEU, ply);
-    	    	/* Did we run out of time? If so, stops deepening iterations */
-    	    	if(get_timeout())
-    	    	    break;
-    	    	mv = mv_tmp;
-    	    }
-    	    /* Stops counting the time, if it hasn't already reached limit */
-    	    stop_alarm();
-    	    /* If the move is still blank, use the partial move found */
-    	    if(IS_BLANK_MOVE(mv))
-    	    	mv = mv_tmp;
-    	    /* Perform the move found in the search */
-    	    move(board, mv);
-    	    /* Returns to the NOP status */
-    	    set_status(NOP);
+    	    /* Search and play our move, unless it's aborted */
+    	    think(board);
     	    break;
     	case PONDER:
-    	    /* Reserved for future use */
-    	    set_status(NOP);
+    	    /* Think on the opponent's time, until it moves */
+    	    ponder(board);
+    	    break;
+    	case ANALYZE:
+    	    /* Analyze the current position, until it changes */
+    	    analyze(board);
     	    break;
     	default:
     	    quit("Error: Invalid search status!\n");
@@ -148,46 +195,494 @@ void *search_loop(void *arg) {
     return NULL;
 }
 
-/* Alpha Beta Pruning - Minimax Search Algorithm */
-move_t alpha_beta(board_t *b, int32_t alpha, int32_t beta, uint32_t ply) {
-    uint8_t i, type;
+/* Initializations of the search (the lookup tables are built with the binary) */
+void init_search(void) {
+    /* Seed the random number generator, used to vary ECO openings */
+    srand(time(NULL));
+    init_material_values();
+    init_history();
+    init_transposition_table();
+    config_alarm(config->max_seconds);
+    max_depth = config->max_depth;
+    max_nodes = config->max_nodes;
+    lmr_scale = config->lmr_scale;
+    init_margins();
+}
+
+/* The margins of futility pruning and razoring come from the level's material
+ * values: a minor piece one ply from the leaves, a rook two plies from them,
+ * and a queen for razoring (each at least the previous one). A level whose
+ * evaluation doesn't count material gets no margins, and no such pruning */
+void init_margins(void) {
+    futility_margin[0] = 0;
+    futility_margin[1] = MAX(abs(piece_value(PAWN)), MAX(abs(piece_value(BISHOP)), abs(piece_value(KNIGHT))));
+    futility_margin[2] = MAX(futility_margin[1], abs(piece_value(ROOK)));
+    razor_margin = MAX(futility_margin[2], abs(piece_value(QUEEN)));
+}
+
+/* Iterative Deepening Search. Returns the best move found for a board */
+move_t search(board_t *b) {
+    uint8_t ply, k, legal;
+    uint64_t iter_start;
+    int32_t eval = 0, eval_tmp;
     move_list_t *list;
-    move_t m, best;
+    move_t mv, mv_tmp;
 
-    /* Query ECO tree */
-    if(atoi(config->name) >= 50)
-        if(query_eco(&m))	    
-    	    return m;
+    /* Sets as blank the move to be played*/
+    SET_BLANK_MOVE(mv);
+    SET_BLANK_MOVE(mv_tmp);
+    /* Starts counting the statistics */
+    clear_stats();
+
+    /* While the game follows a known opening, play from the ECO tree (but
+     * a search with no time limit is there to think) */
+    if(!infinite && atoi(config->name) >= 50 && query_eco(&mv)) {
+    	pv.size = 0;
+    	lines_size = 0;
+    	return mv;
+    }
+
+    /* With a single legal move, there's nothing to think about */
+    list = gen_move_list(b, FALSE);
+    if(list->size == 1 && !infinite) {
+    	mv = list->move[0];
+    	clear_move_list(list);
+    	pv.size = 0;
+    	lines_size = 0;
+    	return mv;
+    }
+    legal = list->size;
+    clear_move_list(list);
+
+    /* Keep what is still valid of the line expected by the last search */
+    start_pv();
+    /* What was learned about the moves in the last search is getting old */
+    age_move_ordering();
+
+    /* Plan the time of this search and start counting it. A search on the
+     * opponent's time has no limit, until the opponent moves */
+    pthread_mutex_lock(&mutex);
+    node_limit = 0;
+    if(!infinite)
+    	start_time_limits(b);
+    pthread_mutex_unlock(&mutex);
+    /* For each depth, search with alpha-beta minimax (as deep as possible,
+     * in an analysis) */
+    for(ply = 1; ply <= (analyzing ? MAX_PLY - 1 : max_depth); ply++) {
+    	iter_start = get_elapsed_usec();
+    	stats.depth = ply;
+    	SET_BLANK_MOVE(root_move);
+    	eval_tmp = aspiration_search(b, ply, IS_BLANK_MOVE(mv) ? NULL : &eval);
+    	mv_tmp = root_best;
+    	/* Did we run out of time? If so, stops deepening iterations, but
+    	 * keep the best move of the unfinished iteration, if it has any */
+    	if(get_timeout()) {
+    	    if(!IS_BLANK_MOVE(root_move)) {
+    	    	mv = root_move;
+    	    	save_pv();
+    	    	save_line(0, root_eval);
+    	    	lines_size = 1;
+    	    	if((post || analyzing) && !root_shown)
+    	    	    print_thinking(ply, &lines[0]);
+    	    }
+    	    break;
+    	}
+    	mv = mv_tmp;
+    	eval = eval_tmp;
+    	save_pv();
+    	save_line(0, eval);
+    	if((post || analyzing) && !root_shown)
+    	    print_thinking(ply, &lines[0]);
+
+    	/* Multi-PV: the best of the other moves, then the best of the rest,
+    	 * and so on. The transposition table already knows most of the tree */
+    	for(k = 1; k < MIN(multi_pv, legal); k++) {
+    	    /* Centered on the score of this line in the previous iteration */
+    	    excluded_size = k;
+    	    eval_tmp = aspiration_search(b, ply, k < lines_size ? &lines[k].eval : NULL);
+    	    if(get_timeout())
+    	    	break;
+    	    save_line(k, eval_tmp);
+    	    if(post || analyzing)
+    	    	print_thinking(ply, &lines[k]);
+    	}
+    	excluded_size = 0;
+    	lines_size = k;
+    	stats.done_nodes = stats.nodes;
+    	stats.done_depth = ply;
+    	if(get_timeout())
+    	    break;
+
+    	/* A mate has been found: deeper iterations won't change it */
+    	if(abs(eval) >= MAX_HEU - MAX_PLY)
+    	    break;
+    	/* Is there time left for another iteration? */
+    	if(time_to_stop(iter_start))
+    	    break;
+    }
+    /* Stops counting the time, if it hasn't already reached limit */
+    stop_alarm();
+    if(post)
+    	print_stats();
+
+    /* If the move is still blank, use the partial move found */
+    if(IS_BLANK_MOVE(mv))
+    	mv = mv_tmp;
+
+    return mv;
+}
+
+/* Search the root at a given depth with an aspiration window: expect a score
+ * close to the one of the previous iteration ('prev', if there's one). If
+ * the score falls out of the window, widen it and search again. Returns the
+ * score, the move is left in root_best */
+int32_t aspiration_search(board_t *b, uint8_t ply, int32_t *prev) {
+    int32_t alpha, beta, delta, eval;
+
+    delta = MAX(1, abs(piece_value(PAWN)) / ASPIRATION_FRACTION);
+    if(prev == NULL) {
+    	alpha = -MAX_HEU;
+    	beta = MAX_HEU;
+    } else {
+    	alpha = MAX(-MAX_HEU, *prev - delta);
+    	beta = MIN(MAX_HEU, *prev + delta);
+    }
+    for(;;) {
+    	/* The previous principal variation is searched first */
+    	follow_pv = !excluded_size;
+    	root_shown = FALSE;
+    	eval = alpha_beta(b, alpha, beta, ply, 0);
+    	if(get_timeout() || (eval > alpha && eval < beta) || (alpha == -MAX_HEU && beta == MAX_HEU))
+    	    return eval;
+    	delta *= 2;
+    	if(eval <= alpha)
+    	    alpha = MAX(-MAX_HEU, alpha - delta);
+    	else
+    	    beta = MIN(MAX_HEU, beta + delta);
+    }
+}
+
+/* Plan the time of the search of a board, from now on, and start the alarm
+ * at its hard limit (and the node count at its budget, if it has one). The
+ * caller must hold the global mutex */
+void start_time_limits(board_t *b) {
+    uint64_t soft, hard, elapsed;
+
+    plan_time(b, (uint64_t) get_config_alarm() * 1000, &soft, &hard);
+    elapsed = get_elapsed_usec();
+    soft_limit = elapsed + soft * 1000;
+    hard_limit = elapsed + hard * 1000;
+    start_alarm(hard);
+    /* The node budget counts from now on, too */
+    node_limit = max_nodes ? stats.nodes + max_nodes : 0;
+}
+
+/* Don't start an iteration after the soft time limit, nor one that can't
+ * finish before the hard limit (unless the search has no limit at all) */
+bool time_to_stop(uint64_t iter_start) {
+    uint64_t elapsed = get_elapsed_usec();
+    bool stop;
+
+    pthread_mutex_lock(&mutex);
+    stop = !infinite && (elapsed >= soft_limit || elapsed + (elapsed - iter_start) * ITERATION_GROWTH >= hard_limit);
+    pthread_mutex_unlock(&mutex);
+    return stop;
+}
+
+/* Analysis: search a board with no time limit, showing every change of the
+ * best line, until the position changes (or the analysis ends) */
+void analyze(board_t *b) {
+    pthread_mutex_lock(&mutex);
+    if(status != ANALYZE) {
+    	pthread_mutex_unlock(&mutex);
+    	return;
+    }
+    searching = TRUE;
+    infinite = TRUE;
+    analyzing = TRUE;
+    pthread_mutex_unlock(&mutex);
+
+    /* A finished game has nothing to analyze */
+    if(end(b) == NO_MATE)
+    	search(b);
+
+    /* If the search is over (a mate, or the maximum depth), keep its line
+     * until the position changes */
+    pthread_mutex_lock(&mutex);
+    while(status == ANALYZE)
+    	pthread_cond_wait(&cond, &mutex);
+    stop_alarm();
+    searching = FALSE;
+    infinite = FALSE;
+    analyzing = FALSE;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+}
+
+/* Search a board on our own time and play the move found, unless the
+ * search is aborted (status changed by the CECP Thread) */
+void think(board_t *b) {
+    move_t mv;
+
+    pthread_mutex_lock(&mutex);
+    if(status != SEARCH) {
+    	pthread_mutex_unlock(&mutex);
+    	return;
+    }
+    searching = TRUE;
+    pthread_mutex_unlock(&mutex);
+
+    mv = search(b);
+
+    pthread_mutex_lock(&mutex);
+    /* A 'move now' may come after the search is over: forget it */
+    stop_alarm();
+    if(status == SEARCH)
+    	play(b, mv);
+    searching = FALSE;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+}
+
+/* Pondering: play the opponent's move expected by the last search and search
+ * the resulting position on its time. When the opponent moves, a ponder hit
+ * (status SEARCH) makes the move found ours, anything else takes the expected
+ * move back */
+void ponder(board_t *b) {
+    move_t mv;
+
+    pthread_mutex_lock(&mutex);
+    if(status != PONDER) {
+    	pthread_mutex_unlock(&mutex);
+    	return;
+    }
+    /* Without an expected move, or if it ends the game, there's nothing to do */
+    if(!get_hint(b, &ponder_move)) {
+    	status = NOP;
+    	pthread_mutex_unlock(&mutex);
+    	return;
+    }
+    move(b, ponder_move);
+    if(end(b) != NO_MATE) {
+    	unmove(b);
+    	status = NOP;
+    	pthread_mutex_unlock(&mutex);
+    	return;
+    }
+    ponder_board = *b;
+    searching = TRUE;
+    infinite = TRUE;
+    pthread_mutex_unlock(&mutex);
+
+    mv = search(b);
+
+    /* If the search is over before the opponent moves, wait for it */
+    pthread_mutex_lock(&mutex);
+    while(status == PONDER)
+    	pthread_cond_wait(&cond, &mutex);
+    /* The search may be over before the alarm of a ponder hit, or stopped
+     * by a ponder miss: either way, there's no time to count anymore */
+    stop_alarm();
+    if(status == SEARCH) {
+    	/* Ponder hit: the move found is ours */
+    	play(b, mv);
+    } else {
+    	/* Ponder miss (or abort): back to the real position */
+    	unmove(b);
+    }
+    searching = FALSE;
+    infinite = FALSE;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+}
+
+/* Play the move found by a search, tell it to the opponent and choose what to
+ * do next: ponder, if enabled and the game goes on, or wait. The caller must
+ * hold the global mutex */
+void play(board_t *b, move_t mv) {
+    /* A draw offer is accepted if the position is a draw, before we move */
+    if(draw_offered && evaluate_draw(b))
+    	printf("offer draw\n");
+    draw_offered = FALSE;
+
+    move(b, mv);
+    status = answer_move() && ponder_enabled ? PONDER : NOP;
+}
+
+/* Stop the search thread, if it's searching, pondering or analyzing, and wait
+ * until it's idle. If the opponent has played the expected move 'm' while pondering,
+ * it's a ponder hit instead: the search goes on, on our own time, and plays
+ * our move without waiting. Otherwise (or if 'm' is NULL) the search is
+ * aborted, with the board restored. Returns TRUE on a ponder hit */
+bool stop_search(move_t *m) {
+    pthread_mutex_lock(&mutex);
+    if(status == PONDER && searching && m && SAME_MOVE(*m, ponder_move)) {
+    	start_time_limits(&ponder_board);
+    	infinite = FALSE;
+    	status = SEARCH;
+    	pthread_cond_broadcast(&cond);
+    	pthread_mutex_unlock(&mutex);
+    	return TRUE;
+    }
+    if(status == SEARCH || status == PONDER || status == ANALYZE) {
+    	if(searching)
+    	    set_timeout(TRUE);
+    	status = NOP;
+    	pthread_cond_broadcast(&cond);
+    	while(searching)
+    	    pthread_cond_wait(&cond, &mutex);
+    }
+    pthread_mutex_unlock(&mutex);
+    return FALSE;
+}
+
+/* Make the current search play the best move found so far ('move now') */
+void move_now(void) {
+    pthread_mutex_lock(&mutex);
+    if(status == SEARCH && searching)
+    	set_timeout(TRUE);
+    pthread_mutex_unlock(&mutex);
+}
+
+/* Turn pondering on or off. The current one, if any, is stopped */
+void set_ponder(bool on) {
+    pthread_mutex_lock(&mutex);
+    ponder_enabled = on;
+    pthread_mutex_unlock(&mutex);
+    if(!on && get_status() == PONDER)
+    	stop_search(NULL);
+}
 
-    /* Query transposition table */
-    type = query_transposition(b->hash, alpha, beta, ply, &m);
+/* The opponent offers a draw: accept it if the position is a draw. While
+ * searching, the board doesn't hold the real position: the offer is judged
+ * right before our move is played */
+void offer_draw(void) {
+    pthread_mutex_lock(&mutex);
+    if(searching)
+    	draw_offered = TRUE;
+    else if(evaluate_draw(board))
+    	printf("offer draw\n");
+    pthread_mutex_unlock(&mutex);
+}
+
+/* Gives the opponent's move expected by the last search, while it's the
+ * opponent's turn (also while pondering on it) */
+bool get_expected_move(move_t *m) {
+    bool found;
+
+    pthread_mutex_lock(&mutex);
+    if(status == PONDER && searching) {
+    	*m = ponder_move;
+    	found = TRUE;
+    } else {
+    	found = !searching && get_hint(board, m);
+    }
+    pthread_mutex_unlock(&mutex);
+    return found;
+}
+
+/* Wait until the search thread has set the board up */
+void wait_search_thread(void) {
+    pthread_mutex_lock(&mutex);
+    while(board == NULL)
+    	pthread_cond_wait(&cond, &mutex);
+    pthread_mutex_unlock(&mutex);
+}
+
+/* Alpha Beta Pruning - Minimax Search Algorithm.
+ * 'ply' is the remaining depth, 'height' the distance from the root */
+int32_t alpha_beta(board_t *b, int32_t alpha, int32_t beta, uint32_t ply, uint8_t height) {
+    uint8_t i, j, type;
+    uint32_t r;
+    int32_t eval, best_eval, static_eval = 0, score[MAX_MOVES];
+    bool in_check, futile = FALSE, pruned = FALSE, has_hash_move;
+    move_list_t *list;
+    move_t best, hash_move;
+
+    stats.nodes++;
+    /* Node budget exhausted: as if the time was up */
+    if(stats.nodes == node_limit)
+    	set_timeout(TRUE);
+
+    /* No line has been found from here yet */
+    pv_length[height] = height;
+
+    /* Query transposition table (but never cut the root, nor any node of the
+     * principal variation, they need a line: there it only orders the moves) */
+    type = height && beta - alpha == 1 ? query_transposition(b->hash, ply, &eval) : TYPE_INVALID;
+    if(type != TYPE_INVALID)
+    	eval = eval_from_table(eval, height);
     switch(type) {
     case TYPE_ALPHA:
-    	/* Chooses the best alpha between the old and the one from the table */
-        alpha = MAX(alpha, m.eval);
-    	/* If we have a Beta cutoff, returns */
-    	if(alpha >= beta)
-    	    return m;
+    	/* The table has an upper bound. If it's below alpha, we fail low */
+    	if(eval <= alpha)
+    	    return eval;
     	break;
     case TYPE_BETA:
-    	/* Chooses the best beta between the old and the one from the table */
-    	beta = MIN(beta, m.eval);
-    	/* If we have a Beta cutoff, returns */
-    	if(alpha >= beta)
-    	    return m;
+    	/* The table has a lower bound. If it's above beta, we fail high */
+    	if(eval >= beta)
+    	    return eval;
     	break;
     case TYPE_EXACT:
     	/* If the table had an exact evaluation, returns it */
-    	return m;
+    	return eval;
     case TYPE_INVALID:
     	/* If the transposition is invalid, just ignore and keep going*/
     	break;
     }
 
-    /* If it's a leaf node, evaluate it properly */
-    if(ply == 0) {
-    	m.eval = heuristic(b, onmove);
-    	return m;
+    in_check = b->checkers != 0;
+
+    /* If it's a leaf node, evaluate it properly, resolving the captures (but
+     * a mate or a stalemate first, the search of the captures can't see them) */
+    if(ply == 0 || height >= MAX_PLY - 1) {
+    	if(height && !has_legal_move(b))
+    	    return no_legal_move(height, in_check);
+    	return quiescence(b, alpha, beta);
+    }
+
+    /* Null move pruning: if the side on move could pass and the opponent
+     * still couldn't get below beta, a real move would fail high too */
+    if(null_move_allowed(b, alpha, beta, ply, height, in_check)) {
+    	move_null(b);
+    	eval = -alpha_beta(b, -beta, -beta + 1, ply > NULL_MOVE_REDUCTION ? ply - 1 - NULL_MOVE_REDUCTION : 0, height + 1);
+    	unmove_null(b);
+    	if(eval >= beta && !get_timeout()) {
+    	    /* With only pawns, passing may be better than any move (zugzwang):
+    	     * a reduced search of the real moves has to agree */
+    	    if(!has_pieces(b, b->onmove)) {
+    	    	j = verify_height;
+    	    	verify_height = height;
+    	    	eval = alpha_beta(b, beta - 1, beta, MAX(1, ply - NULL_MOVE_REDUCTION), height);
+    	    	verify_height = j;
+    	    	pv_length[height] = height;
+    	    }
+    	    if(eval >= beta && !get_timeout())
+    	    	return beta;
+    	}
+    }
+
+    /* Near the leaves of a null window search, a static evaluation far below
+     * alpha isn't likely to get over it with a quiet move */
+    if(height && ply <= FUTILITY_MAX_PLY && beta - alpha == 1 && !in_check && razor_margin > 0 && abs(alpha) < MAX_HEU - MAX_PLY) {
+    	static_eval = heuristic(b, b->onmove);
+    	/* Razoring: so far below that only the captures can help */
+    	if(ply <= RAZOR_MAX_PLY && static_eval + razor_margin <= alpha) {
+    	    eval = quiescence(b, alpha, beta);
+    	    if(eval <= alpha)
+    	    	return eval;
+    	}
+    	/* Futility pruning: the quiet moves are skipped (see below) */
+    	futile = static_eval + futility_margin[ply] <= alpha;
+    }
+
+    /* The move stored for this position is the best guess to try first. With
+     * none, a reduced search of the node finds one (and stores it) */
+    has_hash_move = height && query_transposition_move(b->hash, &hash_move);
+    if(!has_hash_move && height && !follow_pv && ply >= IID_MIN_PLY && (beta - alpha > 1 || ply >= IID_DEEP_PLY)) {
+    	alpha_beta(b, alpha, beta, ply - IID_REDUCTION, height);
+    	pv_length[height] = height;
+    	has_hash_move = query_transposition_move(b->hash, &hash_move);
     }
 
     /* Default type of the value to be inserted in the Transposition table */
@@ -195,116 +690,288 @@ move_t alpha_beta(board_t *b, int32_t alpha, int32_t beta, uint32_t ply) {
 
     /* Initialize the best possible move as blank */
     SET_BLANK_MOVE(best);
+    best_eval = 0;
 
-    /* Get the possible next moves */
+    /* Get the possible next moves: the best captures first, then the quiet
+     * moves that caused cutoffs elsewhere */
     list = gen_move_list(b, FALSE);
+    if(height && list->size == 0) {
+    	clear_move_list(list);
+    	return no_legal_move(height, in_check);
+    }
+    score_captures(b, list, score);
+    score_quiets(b, list, score, height);
+    sort_move_list(list, score);
+    if(has_hash_move)
+    	sort_hash_move(list, score, hash_move);
+
+    /* While on the previous principal variation, try its move first */
+    if(follow_pv)
+    	sort_pv(list, score, height);
+
+    /* A Multi-PV search looks for the best of the root moves not in the
+     * lines already found */
+    if(height == 0 && excluded_size)
+    	exclude_root_moves(list, score);
+
     /* For each possible next move... */
+    if(height == 0)
+    	stats.root_moves = list->size;
     for(i = 0; i < list->size; i++) {
+    	if(height == 0) {
+    	    stats.root_searched = i;
+    	    stats.root_current = list->move[i];
+    	}
     	/* Let's see the board after that move... */
     	move(b, list->move[i]);
+    	pv_length[height + 1] = height + 1;
 
-    	/* Did we reach any end game condition? */
-    	switch(end(b)) {
-    	case CHECK_MATE:
-    	    m.eval = (onmove == b->onmove) ? -MAX_HEU : MAX_HEU;
-    	    break;
-    	case STALE_MATE:
+    	/* A futile node only searches its first move, the captures and
+    	 * promotions, and the moves that give check */
+    	if(futile && i > 0 && score[i] < LOSING_CAPTURE && list->move[i].promotion == NO_PROMOTION &&
+    	   !b->checkers) {
+    	    unmove(b);
+    	    pruned = TRUE;
+    	    continue;
+    	}
+
+    	/* Did we reach a draw by the rules? (A mate or a stalemate is found
+    	 * by the search of the next node, when it has no legal move) */
+    	switch(draw_rules(b)) {
     	case REPETITION:
     	case FIFTY_MOVES:
     	case TWO_KINGS:
-    	    m.eval = -MAX_HEU;
+    	    eval = -DRAW_HEU;
     	    break;
     	case NO_MATE:
     	default:
-    	    /* If not, keep searching down in the search tree */
-    	    m = alpha_beta(b, -beta, -alpha, ply - 1);
-    	    m.eval = -m.eval;
+    	    /* If not, keep searching down in the search tree. Principal
+    	     * Variation Search: the first move gets the whole window, the others
+    	     * just have to prove they aren't better (a null window), and are
+    	     * searched again only if they are */
+    	    /* Late move reductions: a late quiet move has to beat alpha at a
+    	     * reduced depth before it gets the full one */
+    	    r = late_move_reduction(b, list, score, ply, i, in_check);
+    	    if(r) {
+    	    	eval = -alpha_beta(b, -alpha - 1, -alpha, ply - 1 - r, height + 1);
+    	    	if(eval <= alpha)
+    	    	    break;
+    	    	pv_length[height + 1] = height + 1;
+    	    }
+    	    if(i > 0) {
+    	    	eval = -alpha_beta(b, -alpha - 1, -alpha, ply - 1, height + 1);
+    	    	if(eval <= alpha || eval >= beta)
+    	    	    break;
+    	    	pv_length[height + 1] = height + 1;
+    	    }
+    	    eval = -alpha_beta(b, -beta, -alpha, ply - 1, height + 1);
     	    break;
     	}
 
     	/* Restores the previous board (before the possible move) */
     	unmove(b);
 
+    	/* Only the first move can follow the previous principal variation */
+    	follow_pv = FALSE;
+
     	/* Beta cutoff */
-    	if(m.eval >= beta) {
+    	if(eval >= beta) {
     	    best = list->move[i];
-    	    best.eval = m.eval;
+    	    best_eval = eval;
     	    type = TYPE_BETA;
+    	    stats.cutoffs++;
+    	    if(i == 0)
+    	    	stats.first_cutoffs++;
+    	    /* Remember the quiet moves that refute the opponent's play */
+    	    if(list->move[i].promotion == NO_PROMOTION && captured_piece(b, list->move[i]) == -1)
+    	    	update_move_ordering(b, list->move[i], height, ply);
     	    break;
     	/* Alpha cutoff */
-    	} else if(m.eval > alpha) {
+    	} else if(eval > alpha) {
     	    best = list->move[i];
-    	    alpha = best.eval = m.eval;
+    	    alpha = best_eval = eval;
     	    type = TYPE_EXACT;
+    	    /* The new best line is this move followed by the child's line */
+    	    pv_line[height][height] = list->move[i];
+    	    for(j = height + 1; j < pv_length[height + 1]; j++)
+    	    	pv_line[height][j] = pv_line[height + 1][j];
+    	    pv_length[height] = pv_length[height + 1];
+    	    /* At the root, a completely searched move is good to be played,
+    	     * even if the iteration doesn't finish */
+    	    if(height == 0 && !get_timeout()) {
+    	    	root_move = best;
+    	    	root_eval = best_eval;
+    	    	/* An analysis shows each new best move as soon as it's found
+    	    	 * (the first one is shown when the iteration ends) */
+    	    	root_shown = analyzing && i > 0 && !excluded_size;
+    	    	if(root_shown) {
+    	    	    save_pv();
+    	    	    save_line(0, best_eval);
+    	    	    print_thinking(ply, &lines[0]);
+    	    	}
+    	    }
     	/* Best possible move until now */
-    	} else if(i == 0 || m.eval > best.eval) {
+    	} else if(i == 0 || eval > best_eval) {
     	    best = list->move[i];
-    	    best.eval = m.eval;
+    	    best_eval = eval;
     	}
 
     	/* If our time's up, return immediately */
-    	if(get_timeout()) {
-    	    clear_move_list(list);
-    	    return best; /*break;*/
-    	}
+    	if(get_timeout())
+    	    break;
     }
 
-    /* Update the Transposition table */
-    add_transposition(b->hash, type, ply, best);
+    /* The root's best move is the result of the search */
+    if(height == 0)
+    	root_best = best;
+
+    /* The quiet moves skipped by futility pruning aren't known to be worse
+     * than the static evaluation plus its margin: a fail low can't promise
+     * less than that */
+    if(pruned && type == TYPE_ALPHA)
+    	best_eval = MAX(best_eval, static_eval + futility_margin[ply]);
+
+    /* Update the Transposition table (but not with the score of a root
+     * that lacks its best moves, nor of a search cut by the time) */
+    if((height || !excluded_size) && !get_timeout())
+    	add_transposition(b->hash, type, ply, best, eval_to_table(best_eval, height));
 
     /* Clear temporary information and return */
     clear_move_list(list);
-    return best;
+    return best_eval;
 }
 
-/* Quiescence Search */
-move_t quiescence(board_t *b, int32_t alpha, int32_t beta) {
-    uint8_t i;
-    move_t m, best;
+/* The evaluation of a node whose side on move has no legal move: mated (the
+ * sooner, the worse), or stalemated, a draw its opponent should avoid */
+int32_t no_legal_move(uint8_t height, bool in_check) {
+    return in_check ? -(MAX_HEU - height) : DRAW_HEU;
+}
+
+/* A mate score counts the plies from the root, but the same position can be
+ * found at any height: the transposition table keeps it from the node */
+int32_t eval_to_table(int32_t eval, uint8_t height) {
+    if(eval >= MAX_HEU - MAX_PLY)
+    	return eval + height;
+    if(eval <= -(MAX_HEU - MAX_PLY))
+    	return eval - height;
+    return eval;
+}
+
+/* A mate score of the transposition table, counted from the root again */
+int32_t eval_from_table(int32_t eval, uint8_t height) {
+    if(eval >= MAX_HEU - MAX_PLY)
+    	return eval - height;
+    if(eval <= -(MAX_HEU - MAX_PLY))
+    	return eval + height;
+    return eval;
+}
+
+/* Null move pruning is tried in the null window nodes away from the root (the
+ * principal variation is searched first, and whole), with enough depth left
+ * and a beta that isn't a mate score. Not when in check (passing would be
+ * illegal), nor twice in a row, nor in the node being verified, nor with the
+ * king alone (zugzwang is the rule there) */
+bool null_move_allowed(board_t *b, int32_t alpha, int32_t beta, uint32_t ply, uint8_t height, bool in_check) {
+    move_t *last = peek_history_move_top();
+
+    if(!height || follow_pv || beta - alpha > 1 || ply < NULL_MOVE_MIN_PLY || height == verify_height || beta >= MAX_HEU - MAX_PLY)
+    	return FALSE;
+    if(!last || IS_BLANK_MOVE(*last))
+    	return FALSE;
+    if(!b->bitboard[b->onmove][PAWN] && !has_pieces(b, b->onmove))
+    	return FALSE;
+    return !in_check;
+}
+
+/* Late move reductions: how many plies less the i-th move of a node's list is
+ * searched (with the move already on the board). Only the quiet moves late in
+ * the order are reduced: not the killers and countermoves, nor the moves out
+ * of or into check. The reduction leaves at least a ply to search */
+uint32_t late_move_reduction(board_t *b, move_list_t *list, int32_t *score, uint32_t ply, uint8_t i, bool in_check) {
+    uint32_t r;
+
+    if(ply < LMR_MIN_PLY || i < LMR_FULL_MOVES || in_check || score[i] >= LOSING_CAPTURE || list->move[i].promotion != NO_PROMOTION)
+    	return 0;
+    r = lmr_reductions[MIN(ply, MAX_PLY - 1)][MIN(i, LMR_MOVES - 1)] * lmr_scale / (100 * LMR_UNIT);
+    if(r == 0 || b->checkers)
+    	return 0;
+    return MIN(r, ply - 2);
+}
+
+/* Remove from the root moves the first ones of the lines already found */
+void exclude_root_moves(move_list_t *list, int32_t *score) {
+    uint32_t i, size = 0;
+    uint8_t j;
+
+    for(i = 0; i < list->size; i++) {
+    	for(j = 0; j < excluded_size; j++)
+    	    if(SAME_MOVE(list->move[i], lines[j].move[0]))
+    	    	break;
+    	if(j == excluded_size) {
+    	    list->move[size] = list->move[i];
+    	    score[size++] = score[i];
+    	}
+    }
+    list->size = size;
+}
+
+/* Quiescence Search. Searches only the captures (and promotions) until the
+ * position is quiet, so the evaluation isn't taken in the middle of a trade */
+int32_t quiescence(board_t *b, int32_t alpha, int32_t beta) {
+    uint32_t i;
+    int32_t stand_pat, gain, eval, best, score[MAX_MOVES];
+    int8_t victim;
     move_list_t *list;
-    
-    /* Initialize the best possible move as blank */
-    SET_BLANK_MOVE(best);
 
-    m.eval = heuristic(b, onmove);
-    if(m.eval >= beta) {
-    	best.eval = m.eval;
+    stats.nodes++;
+    if(stats.nodes == node_limit)
+    	set_timeout(TRUE);
+
+    /* Stand pat: the side on move may choose not to capture anything */
+    stand_pat = best = heuristic(b, b->onmove);
+    if(stand_pat >= beta)
     	return best;
-    } else if(m.eval > alpha) {
-    	alpha = m.eval;
-    }
+    else if(stand_pat > alpha)
+    	alpha = stand_pat;
 
-    /* Get the next possible Good captures only */
+    /* Get the next possible captures only, the best ones first */
     list = gen_move_list(b, TRUE);
-
-    /*TODO: Re-order the move list (SEE - Static Exchange Eval) */
-    /*reorder_move_list(b, list); */
+    reorder_move_list(b, list, score);
 
     /* For each possible next move... */
     for(i = 0; i < list->size; i++) {
+    	/* Delta pruning: skip the moves that can't raise alpha, even with a
+    	 * safety margin over the material they win */
+    	victim = captured_piece(b, list->move[i]);
+    	gain = (victim == -1 ? 0 : piece_value(victim)) + abs(piece_value(PAWN)) * DELTA_MARGIN;
+    	if(list->move[i].promotion != NO_PROMOTION)
+    	    gain += piece_value(list->move[i].promotion) - piece_value(PAWN);
+    	if(stand_pat + gain <= alpha)
+    	    continue;
+
+    	/* Skip the captures that lose material (SEE - Static Exchange Eval) */
+    	if(list->move[i].promotion == NO_PROMOTION && losing_capture(b, list->move[i]))
+    	    continue;
+
     	/* Let's see the board after that move... */
     	move(b, list->move[i]);
 
     	/* Quiescence Search recursion */
-    	m = quiescence(b, -beta, -alpha);
-    	m.eval = -m.eval;
+    	eval = -quiescence(b, -beta, -alpha);
 
     	/* Restores the previous board (before the possible move) */
     	unmove(b);
 
     	/* Beta cutoff */
-    	if(m.eval >= beta) {
-    	    best = list->move[i];
-    	    best.eval = m.eval;
+    	if(eval >= beta) {
+    	    best = eval;
     	    break;
     	/* Alpha cutoff */
-    	} else if(m.eval > alpha) {
-    	    best = list->move[i];
-    	    alpha = best.eval = m.eval;
+    	} else if(eval > alpha) {
+    	    alpha = best = eval;
     	/* Best possible move until now */
-    	} else if(i == 0 || m.eval > best.eval) {
-    	    best = list->move[i];
-    	    best.eval = m.eval;
+    	} else if(eval > best) {
+    	    best = eval;
     	}
     }
 
@@ -313,11 +980,236 @@ move_t quiescence(board_t *b, int32_t alpha, int32_t beta) {
     return best;
 }
 
+/* Set the ordering score of the quiet moves of a move list (the moves that
+ * still score zero): the killer moves of its height first, then the
+ * countermove of the opponent's last move, then by the history heuristic */
+void score_quiets(board_t *b, move_list_t *list, int32_t *score, uint8_t height) {
+    move_t *last = peek_history_move_top(), counter;
+    uint32_t i;
+
+    SET_BLANK_MOVE(counter);
+    if(last)
+    	counter = countermoves[SQUARE(last->src_y, last->src_x)][SQUARE(last->dst_y, last->dst_x)];
+
+    for(i = 0; i < list->size; i++) {
+    	if(score[i] != 0)
+    	    continue;
+    	if(SAME_MOVE(list->move[i], killers[height][0]))
+    	    score[i] = KILLER_MOVE + 1;
+    	else if(SAME_MOVE(list->move[i], killers[height][1]))
+    	    score[i] = KILLER_MOVE;
+    	else if(SAME_MOVE(list->move[i], counter))
+    	    score[i] = COUNTER_MOVE;
+    	else
+    	    score[i] = history_score[b->onmove][SQUARE(list->move[i].src_y, list->move[i].src_x)][SQUARE(list->move[i].dst_y, list->move[i].dst_x)];
+    }
+}
+
+/* A quiet move has caused a beta cutoff: make it a killer move of its height,
+ * the countermove of the opponent's last move, and raise its history score */
+void update_move_ordering(board_t *b, move_t m, uint8_t height, uint32_t ply) {
+    move_t *last = peek_history_move_top();
+    int32_t *score = &history_score[b->onmove][SQUARE(m.src_y, m.src_x)][SQUARE(m.dst_y, m.dst_x)];
+    uint32_t color, src, dst;
+
+    if(!SAME_MOVE(m, killers[height][0])) {
+    	killers[height][1] = killers[height][0];
+    	killers[height][0] = m;
+    }
+
+    if(last)
+    	countermoves[SQUARE(last->src_y, last->src_x)][SQUARE(last->dst_y, last->dst_x)] = m;
+
+    /* Deeper cutoffs are worth more. Keep the scores below the other moves */
+    *score += ply * ply;
+    if(*score > HISTORY_MAX)
+    	for(color = COLOR_BLACK; color < COLORS; color++)
+    	    for(src = 0; src < 64; src++)
+    	    	for(dst = 0; dst < 64; dst++)
+    	    	    history_score[color][src][dst] /= 2;
+}
+
+/* Age the move ordering tables between two searches: the killer moves belong
+ * to heights of the last search, and the history scores fade away */
+void age_move_ordering(void) {
+    uint32_t color, src, dst;
+
+    memset(killers, 0, sizeof(killers));
+    for(color = COLOR_BLACK; color < COLORS; color++)
+    	for(src = 0; src < 64; src++)
+    	    for(dst = 0; dst < 64; dst++)
+    	    	history_score[color][src][dst] /= HISTORY_AGING;
+}
+
+/* Forget everything learned about the moves (e.g. for a new game) */
+void clear_move_ordering(void) {
+    memset(killers, 0, sizeof(killers));
+    memset(history_score, 0, sizeof(history_score));
+    memset(countermoves, 0, sizeof(countermoves));
+}
+
+/* Moves the move of the previous principal variation at a given height to the
+ * front of a move list. If it isn't there, we have left that variation */
+void sort_pv(move_list_t *list, int32_t *score, uint8_t height) {
+    uint32_t i;
+
+    if(height < pv.size)
+    	for(i = 0; i < list->size; i++)
+    	    if(SAME_MOVE(list->move[i], pv.move[height])) {
+    	    	swap_moves(list, score, 0, i);
+    	    	return;
+    	    }
+
+    follow_pv = FALSE;
+}
+
+/* Move the hash move to the front of a sorted move list, keeping the order
+ * of the others */
+void sort_hash_move(move_list_t *list, int32_t *score, move_t m) {
+    uint32_t i;
+
+    for(i = 0; i < list->size; i++)
+    	if(SAME_MOVE(list->move[i], m)) {
+    	    first_move(list, score, i);
+    	    return;
+    	}
+}
+
+/* Prepare the principal variation for a new search. If the game went the
+ * way the last search expected, the rest of its line is still useful */
+void start_pv(void) {
+    move_t *m;
+    uint8_t i;
+
+    m = peek_history_move_top();
+    if(pv.size > 2 && pv.searched + 2 == peek_history_size() && m && SAME_MOVE(*m, pv.move[1])) {
+    	for(i = 2; i < pv.size; i++)
+    	    pv.move[i - 2] = pv.move[i];
+    	pv.size -= 2;
+    } else {
+    	pv.size = 0;
+    }
+}
+
+/* Save the line found by a complete iteration as the principal variation */
+void save_pv(void) {
+    uint8_t i;
+
+    for(i = 0; i < pv_length[0]; i++)
+    	pv.move[i] = pv_line[0][i];
+    pv.size = pv_length[0];
+    pv.searched = peek_history_size();
+}
+
+/* Save the line found at the root as the k-th best one, with its score */
+void save_line(uint8_t k, int32_t eval) {
+    uint8_t i;
+
+    for(i = 0; i < pv_length[0]; i++)
+    	lines[k].move[i] = pv_line[0][i];
+    lines[k].size = pv_length[0];
+    lines[k].searched = peek_history_size();
+    lines[k].eval = eval;
+}
+
+/* Copies the best lines found by the last search. Returns how many there are */
+uint8_t get_lines(pv_t *l) {
+    memcpy(l, lines, lines_size * sizeof(pv_t));
+    return lines_size;
+}
+
+/* Copies the principal variation found by the last search. Returns its size */
+uint8_t get_pv(move_t *line) {
+    memcpy(line, pv.move, pv.size * sizeof(move_t));
+    return pv.size;
+}
+
+/* Gives the opponent's move expected by the last search, if it is still the
+ * opponent's turn. Returns FALSE if there is no such move */
+bool get_hint(board_t *b, move_t *m) {
+    move_t *last = peek_history_move_top();
+
+    if(pv.size < 2 || pv.searched + 1 != peek_history_size() || !last || !SAME_MOVE(*last, pv.move[0]))
+    	return FALSE;
+    if(!check_valid_move(b, pv.move[1]))
+    	return FALSE;
+
+    *m = pv.move[1];
+    return TRUE;
+}
+
+/* Reset the statistics and the clock of the search process */
+void clear_stats(void) {
+    memset(&stats, 0, sizeof(stats_t));
+    clear_table_stats();
+    gettimeofday(&start_time, NULL);
+}
+
+/* Returns the number of nodes visited by the current (or last) search */
+uint64_t get_search_nodes(void) {
+    return stats.nodes;
+}
+
+/* Returns the time elapsed since the search has started, in microseconds */
+uint64_t get_elapsed_usec(void) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return (uint64_t) (now.tv_sec - start_time.tv_sec) * 1000000 + (now.tv_usec - start_time.tv_usec);
+}
+
+/* Print the thinking output of a complete iteration, in the xboard format:
+ * ply, score, time (in centiseconds), nodes and principal variation */
+void print_thinking(uint8_t ply, pv_t *line) {
+    char coord[8];
+    uint8_t i;
+
+    printf("%d %d %llu %llu", ply, line->eval, (unsigned long long) get_elapsed_usec() / 10000, (unsigned long long) stats.nodes);
+    for(i = 0; i < line->size; i++)
+        if(move_to_coord(coord, &line->move[i]))
+            printf(" %s", coord);
+    printf("\n");
+}
+
+/* Print the extended statistics of a search: nodes per second, hit rate of
+ * the transposition table, rate of beta cutoffs on the first move tried and
+ * the effective branching factor (the root of the nodes visited up to the last
+ * complete iteration, by its depth: the ratio of two iterations means little
+ * when the transposition table makes the first ones almost free) */
+void print_stats(void) {
+    uint64_t usec = get_elapsed_usec(), hits, misses;
+    double ebf = 0.0;
+
+    get_table_stats(&hits, &misses);
+
+    if(stats.done_depth > 0)
+        ebf = pow((double) stats.done_nodes, 1.0 / stats.done_depth);
+
+    printf("# nodes %llu time %llu nps %llu tthits %.1f%% firstcut %.1f%% ebf %.2f\n",
+           (unsigned long long) stats.nodes, (unsigned long long) usec / 1000,
+           (unsigned long long) (usec ? stats.nodes * 1000000 / usec : 0),
+           (hits + misses) ? 100.0 * hits / (hits + misses) : 0.0,
+           stats.cutoffs ? 100.0 * stats.first_cutoffs / stats.cutoffs : 0.0, ebf);
+}
+
+/* Print the state of the current analysis (answer to the '.' command): time
+ * (in centiseconds), nodes, depth, moves left and total moves at the root, and
+ * the move being searched */
+void print_search_status(void) {
+    char coord[8];
+
+    pthread_mutex_lock(&mutex);
+    if(analyzing && move_to_coord(coord, &stats.root_current))
+    	printf("stat01: %llu %llu %d %d %d %s\n", (unsigned long long) get_elapsed_usec() / 10000,
+    	       (unsigned long long) stats.nodes, stats.depth, stats.root_moves - stats.root_searched - 1,
+    	       stats.root_moves, coord);
+    pthread_mutex_unlock(&mutex);
+}
+
 /* Set search thread status and signalize the global condition */
 void set_status(status_t s) {
     pthread_mutex_lock(&mutex);
     status = s;
-    pthread_cond_signal(&cond);
+    pthread_cond_broadcast(&cond);
     pthread_mutex_unlock(&mutex);
 }
 
@@ -326,16 +1218,6 @@ status_t get_status(void) {
     return status;
 }
 
-/* Set search thread status, signalize the global condition
- * and then wait until the global condition is signalized back. */
-void set_status_and_wait(status_t s) {
-    pthread_mutex_lock(&mutex);
-    status = s;
-    pthread_cond_signal(&cond);
-    pthread_cond_wait(&cond, &mutex);
-    pthread_mutex_unlock(&mutex);
-}
-
 /* Return the value of the timeout flag */
 bool get_timeout(void) {
     bool t;
@@ -365,11 +1247,15 @@ uint32_t get_config_alarm(void) {
     return (uint32_t) alarm_clock.tv_sec;
 }
 
-/* Start ticking the alarm */
-void start_alarm(void) {
+/* Start ticking the alarm, to sound after a given time (in milliseconds) */
+void start_alarm(uint64_t msec) {
     struct itimerval t;
     t.it_interval.tv_sec = t.it_interval.tv_usec = 0;
-    t.it_value = alarm_clock;
+    t.it_value.tv_sec = msec / 1000;
+    t.it_value.tv_usec = (msec % 1000) * 1000;
+    /* A zero time would disarm the alarm instead */
+    if(msec == 0)
+        t.it_value.tv_usec = 1;
     if(setitimer(ITIMER_REAL, &t, NULL) == -1)
         quit("Error: Could not start alarm!\n");
 }
@@ -36,28 +36,146 @@ CECP Thread) and function prototypes, used out of this module.
 
 #define MAX_HEU 999999
 
+/* Safety margin of the delta pruning in the quiescence search, in pawns */
+#define DELTA_MARGIN 2
+
+/* Maximum distance from the root a search can reach */
+#define MAX_PLY 64
+
+/* Score of a draw (repetition, stalemate, fifty moves, no material left) for
+ * the side that gets there: as bad as it gets, but for being mated (the mate
+ * scores are the ones beyond MAX_HEU - MAX_PLY) */
+#define DRAW_HEU (MAX_HEU - MAX_PLY - 1)
+
+/* Maximum number of best lines of a Multi-PV search */
+#define MAX_MULTI_PV 8
+
+/* Null move pruning: depth reduction of the search after a null move, and the
+ * minimum depth left to try one */
+#define NULL_MOVE_REDUCTION 2
+#define NULL_MOVE_MIN_PLY 2
+
+/* Futility pruning works on the nodes with up to this depth left, razoring
+ * on the ones with up to this depth */
+#define FUTILITY_MAX_PLY 2
+#define RAZOR_MAX_PLY 2
+
+/* Late move reductions: the moves searched at full depth in each node, and
+ * the minimum depth left to reduce the others */
+#define LMR_FULL_MOVES 3
+#define LMR_MIN_PLY 3
+/* Size of the reduction table (depth left x move number), and the fraction
+ * of a ply (1/n) its values are given in */
+#define LMR_MOVES 64
+#define LMR_UNIT 4
+
+/* Internal iterative deepening: the minimum depth left to search a node
+ * without a hash move at a reduced depth (in the principal variation, or
+ * anywhere with a depth left of IID_DEEP_PLY), and that reduction */
+#define IID_MIN_PLY 4
+#define IID_DEEP_PLY 7
+#define IID_REDUCTION 2
+
+/* Initial half width of the aspiration windows, as a fraction of a pawn */
+#define ASPIRATION_FRACTION 2
+
+/* Killer moves kept for each height of the search */
+#define KILLERS 2
+/* Maximum history score of a move (they are halved when one gets there) */
+#define HISTORY_MAX (LOSING_CAPTURE - 1)
+/* The history scores are divided by this between two searches */
+#define HISTORY_AGING 4
+
 #define ALARM_INIT_SEC 3
 #define ALARM_INIT_USEC 0
 
 /* Search status */
-typedef enum {NOP, FORCE, SEARCH, PONDER, QUIT} status_t;
+typedef enum {NOP, FORCE, SEARCH, PONDER, ANALYZE, QUIT} status_t;
+
+/* Statistics of a search process */
+typedef struct {
+    uint64_t nodes;         /* Nodes visited */
+    uint64_t cutoffs;       /* Beta cutoffs */
+    uint64_t first_cutoffs; /* Beta cutoffs caused by the first move tried */
+    uint64_t done_nodes;    /* Nodes visited up to the last complete iteration */
+    uint8_t done_depth;     /* Depth of the last complete iteration */
+    uint8_t depth;          /* Depth of the current iteration */
+    uint8_t root_moves;     /* Moves to search at the root */
+    uint8_t root_searched;  /* Moves of the root already tried */
+    move_t root_current;    /* Move of the root being searched */
+} stats_t;
+
+/* Principal variation (the best line found by a search) */
+typedef struct {
+    move_t move[MAX_PLY]; /* Moves of the line */
+    uint8_t size;         /* Number of moves in the line */
+    uint32_t searched;    /* History size when the line was searched */
+    int32_t eval;         /* Score of the line */
+} pv_t;
+
+/* Reduction of each late move, by depth left and move number (tablegen.c) */
+extern const uint8_t lmr_reductions[MAX_PLY][LMR_MOVES];
+
 /* The main (current) board */
 extern board_t *board;
 
 extern uint8_t max_depth;
+extern uint64_t max_nodes;
+extern uint8_t multi_pv;
+extern bool post;
+extern bool ponder_enabled;
 
 /* Function prototypes */
 void *search_loop(void *arg);
-move_t alpha_beta(board_t *b, int32_t alpha, int32_t beta, uint32_t ply);
-move_t quiescence(board_t *b, int32_t alpha, int32_t beta);
+void init_search(void);
+void clear_stats(void);
+void score_quiets(board_t *b, move_list_t *list, int32_t *score, uint8_t height);
+void update_move_ordering(board_t *b, move_t m, uint8_t height, uint32_t ply);
+void age_move_ordering(void);
+void clear_move_ordering(void);
+void sort_pv(move_list_t *list, int32_t *score, uint8_t height);
+void sort_hash_move(move_list_t *list, int32_t *score, move_t m);
+void start_pv(void);
+void save_pv(void);
+void save_line(uint8_t k, int32_t eval);
+uint8_t get_lines(pv_t *l);
+void exclude_root_moves(move_list_t *list, int32_t *score);
+int32_t no_legal_move(uint8_t height, bool in_check);
+int32_t eval_to_table(int32_t eval, uint8_t height);
+int32_t eval_from_table(int32_t eval, uint8_t height);
+bool null_move_allowed(board_t *b, int32_t alpha, int32_t beta, uint32_t ply, uint8_t height, bool in_check);
+void init_margins(void);
+uint32_t late_move_reduction(board_t *b, move_list_t *list, int32_t *score, uint32_t ply, uint8_t i, bool in_check);
+uint8_t get_pv(move_t *line);
+bool get_hint(board_t *b, move_t *m);
+void print_thinking(uint8_t ply, pv_t *line);
+void print_stats(void);
+void print_search_status(void);
+uint64_t get_search_nodes(void);
+uint64_t get_elapsed_usec(void);
+move_t search(board_t *b);
+int32_t aspiration_search(board_t *b, uint8_t ply, int32_t *prev);
+void start_time_limits(board_t *b);
+bool time_to_stop(uint64_t iter_start);
+void think(board_t *b);
+void ponder(board_t *b);
+void analyze(board_t *b);
+void play(board_t *b, move_t mv);
+bool stop_search(move_t *m);
+void move_now(void);
+void set_ponder(bool on);
+void offer_draw(void);
+bool get_expected_move(move_t *m);
+void wait_search_thread(void);
+int32_t alpha_beta(board_t *b, int32_t alpha, int32_t beta, uint32_t ply, uint8_t height);
+int32_t quiescence(board_t *b, int32_t alpha, int32_t beta);
 void set_status(status_t s);
 status_t get_status(void);
-void set_status_and_wait(status_t s);
 bool get_timeout(void);
 void set_timeout(bool t);
 void config_alarm(uint32_t secs);
 uint32_t get_config_alarm(void);
-void start_alarm(void);
+void start_alarm(uint64_t msec);
 struct timeval stop_alarm(void);
 void sigalrm_handler(int useless);
 #endif
@@ -0,0 +1,165 @@
+/* Copyright (C) 2007-2008 Centro de Computacao Cientifica e Software Livre
+ * Departamento de Informatica - Universidade Federal do Parana - C3SL/UFPR
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301,
+ * USA.
+ */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ChessD BoT - A Free Chess Engine, intended to be used by children and teenagers
+learning how to play Chess.
+
+see.c
+Static Exchange Evaluation module. Tells, without searching, how much material
+a capture wins or loses once every piece attacking the target square has taken
+part in the exchange (cheapest pieces first), including the sliding pieces
+hidden behind others (x-rays). The attackers of a square are computed for any
+occupancy of the board, with the rays generated at build time.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "see.h"
+
+/* Usual value of each piece (in pawns), used to tell good captures from bad
+ * ones. The level's material values may be far from them on purpose */
+const int32_t exchange_value[PIECES] = {1, 3, 3, 5, 9, 100};
+
+/* Squares attacked from a square along a direction, up to the first piece
+ * of a given occupancy (included) */
+bitboard_t ray_attacks(bitboard_t occ, uint8_t dir, uint8_t y, uint8_t x) {
+    bitboard_t attacks = rays[dir][y][x], blockers = attacks & occ;
+    int8_t sq;
+
+    if(blockers) {
+        sq = (dir < DIR_S) ? FIRST_BIT(blockers) : LAST_BIT(blockers);
+        attacks ^= rays[dir][sq/8][sq%8];
+    }
+    return attacks;
+}
+
+/* Squares attacked by a rook (or a queen) on a square */
+bitboard_t rook_attacks(bitboard_t occ, uint8_t y, uint8_t x) {
+    return ray_attacks(occ, DIR_N, y, x) | ray_attacks(occ, DIR_S, y, x) |
+           ray_attacks(occ, DIR_W, y, x) | ray_attacks(occ, DIR_E, y, x);
+}
+
+/* Squares attacked by a bishop (or a queen) on a square */
+bitboard_t bishop_attacks(bitboard_t occ, uint8_t y, uint8_t x) {
+    return ray_attacks(occ, DIR_NW, y, x) | ray_attacks(occ, DIR_SE, y, x) |
+           ray_attacks(occ, DIR_NE, y, x) | ray_attacks(occ, DIR_SW, y, x);
+}
+
+/* Pieces of both colors attacking a square, for a given occupancy */
+bitboard_t attackers(board_t *b, uint8_t y, uint8_t x, bitboard_t occ) {
+    bitboard_t result, diagonal, straight, sides = moves_king[y][x] & ~file[x];
+
+    diagonal = b->bitboard[COLOR_BLACK][BISHOP] | b->bitboard[COLOR_WHITE][BISHOP] |
+               b->bitboard[COLOR_BLACK][QUEEN] | b->bitboard[COLOR_WHITE][QUEEN];
+    straight = b->bitboard[COLOR_BLACK][ROOK] | b->bitboard[COLOR_WHITE][ROOK] |
+               b->bitboard[COLOR_BLACK][QUEEN] | b->bitboard[COLOR_WHITE][QUEEN];
+
+    result = (moves_knight[y][x] & (b->bitboard[COLOR_BLACK][KNIGHT] | b->bitboard[COLOR_WHITE][KNIGHT])) |
+             (moves_king[y][x] & (b->bitboard[COLOR_BLACK][KING] | b->bitboard[COLOR_WHITE][KING])) |
+             (bishop_attacks(occ, y, x) & diagonal) | (rook_attacks(occ, y, x) & straight);
+
+    /* White pawns attack upwards, from the rank below, and black ones from the
+     * rank above */
+    if(y > RANK_1)
+        result |= sides & rank[y - 1] & b->bitboard[COLOR_WHITE][PAWN];
+    if(y < RANK_8)
+        result |= sides & rank[y + 1] & b->bitboard[COLOR_BLACK][PAWN];
+
+    return result & occ;
+}
+
+/* Static Exchange Evaluation of a move (in pawns). The side moving is the
+ * color of the piece on the source square. Non-captures are evaluated too,
+ * telling whether the piece is safe on its destination */
+int32_t see(board_t *b, move_t m) {
+    int32_t gain[32], d = 0;
+    int8_t piece, victim, color, sq;
+    bitboard_t occ, from = 0, attack, diagonal, straight;
+
+    color = GET_BIT(b->rotation[COLOR_WHITE][ROT_0], m.src_y, m.src_x) ? COLOR_WHITE : COLOR_BLACK;
+    piece = piece_at(b, color, m.src_y, m.src_x);
+    if(piece == -1)
+        return 0;
+
+    occ = b->rotation[COLORS][ROT_0];
+    diagonal = b->bitboard[COLOR_BLACK][BISHOP] | b->bitboard[COLOR_WHITE][BISHOP] |
+               b->bitboard[COLOR_BLACK][QUEEN] | b->bitboard[COLOR_WHITE][QUEEN];
+    straight = b->bitboard[COLOR_BLACK][ROOK] | b->bitboard[COLOR_WHITE][ROOK] |
+               b->bitboard[COLOR_BLACK][QUEEN] | b->bitboard[COLOR_WHITE][QUEEN];
+
+    /* The first capture, which may be an en-passant one */
+    victim = piece_at(b, !color, m.dst_y, m.dst_x);
+    if(victim == -1 && color == b->onmove && piece == PAWN && m.src_x != m.dst_x) {
+        victim = PAWN;
+        CLEAR_BIT(occ, m.src_y, m.dst_x);
+    }
+    gain[0] = (victim == -1) ? 0 : exchange_value[victim];
+    if(m.promotion != NO_PROMOTION) {
+        gain[0] += exchange_value[m.promotion] - exchange_value[PAWN];
+        piece = m.promotion;
+    }
+    SET_BIT(from, m.src_y, m.src_x);
+    attack = attackers(b, m.dst_y, m.dst_x, occ);
+
+    do {
+        d++;
+        color = !color;
+        /* Score of the capture of the last piece, if it's defended */
+        gain[d] = exchange_value[piece] - gain[d - 1];
+        /* Whatever comes next, the exchange won't change the result */
+        if(MAX(-gain[d - 1], gain[d]) < 0)
+            break;
+
+        /* Take the last piece out, letting the sliding pieces behind it in */
+        occ &= ~from;
+        attack &= ~from;
+        attack |= (bishop_attacks(occ, m.dst_y, m.dst_x) & diagonal) |
+                  (rook_attacks(occ, m.dst_y, m.dst_x) & straight);
+        attack &= occ;
+
+        /* The least valuable attacker of the side to capture now */
+        from = 0;
+        for(piece = PAWN; piece < PIECES; piece++)
+            if(attack & b->bitboard[color][piece]) {
+                sq = FIRST_BIT(attack & b->bitboard[color][piece]);
+                SET_BIT(from, sq/8, sq%8);
+                break;
+            }
+    } while(from && d < 31);
+
+    /* Each side may stop the exchange when it's good enough for it */
+    while(--d)
+        gain[d - 1] = -MAX(-gain[d - 1], gain[d]);
+
+    return gain[0];
+}
+
+/* Returns TRUE if a given color can win material right now, capturing
+ * any opponent's piece */
+bool winning_capture(board_t *b, uint8_t color) {
+    int8_t sq, src;
+    bitboard_t targets = b->rotation[!color][ROT_0], from;
+
+    for(; (sq = FIRST_BIT(targets)) != -1; CLEAR_BIT(targets, sq/8, sq%8)) {
+        from = attackers(b, sq/8, sq%8, b->rotation[COLORS][ROT_0]) & b->rotation[color][ROT_0];
+        for(; (src = FIRST_BIT(from)) != -1; CLEAR_BIT(from, src/8, src%8))
+            if(see(b, gen_move(src/8, src%8, sq/8, sq%8, NO_PROMOTION)) > 0)
+                return TRUE;
+    }
+    return FALSE;
+}
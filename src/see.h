@@ -0,0 +1,46 @@
+/* Copyright (C) 2007-2008 Centro de Computacao Cientifica e Software Livre
+ * Departamento de Informatica - Universidade Federal do Parana - C3SL/UFPR
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301,
+ * USA.
+ */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ChessD BoT - A Free Chess Engine, intended to be used by children and teenagers
+learning how to play Chess.
+
+see.h
+Static Exchange Evaluation module header file. Contains the usual values of
+the pieces and the function prototypes.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef _SEE_H_
+#define _SEE_H_
+
+#include "main.h"
+#include "board.h"
+#include "moves.h"
+
+/* Usual value of each piece, in pawns */
+extern const int32_t exchange_value[PIECES];
+
+/* Function prototypes */
+bitboard_t ray_attacks(bitboard_t occ, uint8_t dir, uint8_t y, uint8_t x);
+bitboard_t rook_attacks(bitboard_t occ, uint8_t y, uint8_t x);
+bitboard_t bishop_attacks(bitboard_t occ, uint8_t y, uint8_t x);
+bitboard_t attackers(board_t *b, uint8_t y, uint8_t x, bitboard_t occ);
+int32_t see(board_t *b, move_t m);
+bool winning_capture(board_t *b, uint8_t color);
+#endif
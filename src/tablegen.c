@@ -0,0 +1,306 @@
+/* Copyright (C) 2007-2008 Centro de Computacao Cientifica e Software Livre
+ * Departamento de Informatica - Universidade Federal do Parana - C3SL/UFPR
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301,
+ * USA.
+ */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ChessD BoT - A Free Chess Engine, intended to be used by children and teenagers
+learning how to play Chess.
+
+tablegen.c
+Lookup tables generator. A small program, run at build time, that computes the
+move tables, the rays, the distance tables, the zobrist hash keys and the late
+move reductions, and prints them as C source code with constant arrays. Being
+constant, those tables are compiled into read-only pages of the engine, shared
+by every running process, and nothing has to be computed when the engine
+starts.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include <math.h>
+#include "board.h"
+#include "search.h"
+
+/* Seed of the zobrist keys generator. Any non-zero value will do */
+#define ZOBRIST_SEED 0x2545F4914F6CDD1DULL
+
+/* Tables to be generated */
+static bitboard_t knight_moves[8][8], king_moves[8][8];
+static bitline_t slide_moves[8][256];
+static bitboard_t king_distance[RANKS][FILES][8];
+static uint8_t dist[RANKS][FILES][RANKS][FILES];
+static bitboard_t ray[DIRECTIONS][RANKS][FILES];
+static uint64_t key_piece[COLORS][PIECES][RANKS][FILES], key_castle[16], key_enpassant[16], key_white_onmove;
+static uint8_t reductions[MAX_PLY][LMR_MOVES];
+
+/* Returns a pseudo-random 64bit number (xorshift64*). It doesn't depend on
+ * the C library, so every build gets the very same keys. */
+static uint64_t rand64(void) {
+    static uint64_t state = ZOBRIST_SEED;
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+/* Generate move tables used extensively by move generation */
+static void precompute_moves(void) {
+    uint8_t x, y;
+    int16_t line, i, j;
+
+    /* Knight moves */
+    for(y = 0; y < 8; y++)
+        for(x = 0; x < 8; x++) {
+            knight_moves[y][x] = 0;
+            if(y-2 >= 0 && x-1 >= 0)
+                SET_BIT(knight_moves[y][x],y-2,x-1);
+            if(y-2 >= 0 && x+1 <= 7)
+                SET_BIT(knight_moves[y][x],y-2,x+1);
+            if(y-1 >= 0 && x-2 >= 0)
+                SET_BIT(knight_moves[y][x],y-1,x-2);
+            if(y-1 >= 0 && x+2 <= 7)
+                SET_BIT(knight_moves[y][x],y-1,x+2);
+            if(y+1 <= 7 && x-2 >= 0)
+                SET_BIT(knight_moves[y][x],y+1,x-2);
+            if(y+1 <= 7 && x+2 <= 7)
+                SET_BIT(knight_moves[y][x],y+1,x+2);
+            if(y+2 <= 7 && x-1 >= 0)
+                SET_BIT(knight_moves[y][x],y+2,x-1);
+            if(y+2 <= 7 && x+1 <= 7)
+                SET_BIT(knight_moves[y][x],y+2,x+1);
+        }
+
+    /* King moves */
+    for(y = 0; y < 8; y++)
+        for(x = 0; x < 8; x++) {
+            king_moves[y][x] = 0;
+            if(y-1 >= 0 && x-1 >= 0)
+                SET_BIT(king_moves[y][x],y-1,x-1);
+            if(y-1 >= 0)
+                SET_BIT(king_moves[y][x],y-1,x);
+            if(y-1 >= 0 && x+1 <= 7)
+                SET_BIT(king_moves[y][x],y-1,x+1);
+            if(x-1 >= 0)
+                SET_BIT(king_moves[y][x],y,x-1);
+            if(x+1 <= 7)
+                SET_BIT(king_moves[y][x],y,x+1);
+            if(y+1 <= 7 && x-1 >= 0)
+                SET_BIT(king_moves[y][x],y+1,x-1);
+            if(y+1 <= 7)
+                SET_BIT(king_moves[y][x],y+1,x);
+            if(y+1 <= 7 && x+1 <= 7)
+                SET_BIT(king_moves[y][x],y+1,x+1);
+        }
+
+    /* Slide moves (Rook, Bishop & Queen) */
+    for(j = 0; j < 8; j++)
+        for(line = 0; line < 256; line++) {
+            slide_moves[j][line] = 0;
+            for(i = 1; j+i < 8; i++) {
+                SET_BIT(slide_moves[j][line],0,j+i);
+                if(GET_BIT(line,0,j+i))
+                    break;
+            }
+            for(i = 1; j-i >= 0; i++) {
+                SET_BIT(slide_moves[j][line],0,j-i);
+                if(GET_BIT(line,0,j-i))
+                    break;
+            }
+        }
+}
+
+/* Compute the rays: the squares on each direction from each square, up to
+ * the edge of the board */
+static void precompute_rays(void) {
+    const int8_t dy[DIRECTIONS] = {1, 0, 1, 1, -1, 0, -1, -1};
+    const int8_t dx[DIRECTIONS] = {0, 1, 1, -1, 0, -1, -1, 1};
+    int8_t dir, y, x, i, j;
+
+    for(dir = 0; dir < DIRECTIONS; dir++)
+        for(y = 0; y < 8; y++)
+            for(x = 0; x < 8; x++) {
+                ray[dir][y][x] = 0;
+                for(i = y + dy[dir], j = x + dx[dir]; i >= 0 && i < 8 && j >= 0 && j < 8; i += dy[dir], j += dx[dir])
+                    SET_BIT(ray[dir][y][x], i, j);
+            }
+}
+
+/* Compute the distance matrices */
+static void precompute_distances(void) {
+    uint8_t src, src_y, src_x, dst, dst_y, dst_x, d, i, dx, dy;
+
+    /* Calculate the distances matrix (king moves distance) */
+    for(src = 0; src < 64; src++)
+        for(dst = 0; dst < 64; dst++) {
+            src_y = src/8;
+            src_x = src%8;
+            dst_y = dst/8;
+            dst_x = dst%8;
+            dx = src_x > dst_x ? src_x - dst_x : dst_x - src_x;
+            dy = src_y > dst_y ? src_y - dst_y : dst_y - src_y;
+            dist[src_y][src_x][dst_y][dst_x] = MAX(dx,dy);
+        }
+
+    /* Set the bitboards accordingly with king moves */
+    for(src = 0; src < 64; src++)
+        for(dst = 0; dst < 64; dst++) {
+            src_y = src/8;
+            src_x = src%8;
+            dst_y = dst/8;
+            dst_x = dst%8;
+            SET_BIT(king_distance[src_y][src_x][dist[src_y][src_x][dst_y][dst_x]], dst_y, dst_x);
+        }
+
+    /* Add the lesser distances to each bitboard */
+    for(src = 0; src < 64; src++)
+        for(d = 0; d < 8; d++)
+            for(i = 0; i < d; i++) {
+                src_y = src/8;
+                src_x = src%8;
+                king_distance[src_y][src_x][d] |= king_distance[src_y][src_x][i];
+            }
+}
+
+/* Compute the zobrist hash keys for every board component */
+static void precompute_zobrist_keys(void) {
+    uint8_t castle, enpassant, color, piece, y, x;
+
+    /* Keys of the pieces for each position */
+    for(color = COLOR_BLACK; color < COLORS; color++)
+        for(piece = PAWN; piece < PIECES; piece++)
+            for(y = 0; y < 8; y++)
+                for(x = 0; x < 8; x++)
+                    key_piece[color][piece][y][x] = rand64();
+
+    /* Keys of the castle conditions */
+    for(castle = 0; castle <= CASTLE_ALL; castle++)
+        key_castle[castle] = rand64();
+
+    /* Keys of the en-passant conditions */
+    enpassant = 0;
+    ENPASSANT_SET_VALID(enpassant, TRUE);
+    for(x = 0; x < 8; x++) {
+        ENPASSANT_SET_FILE(enpassant, x);
+        key_enpassant[enpassant] = rand64();
+    }
+    ENPASSANT_SET_VALID(enpassant, FALSE);
+    ENPASSANT_SET_FILE(enpassant, 0);
+    key_enpassant[enpassant] = rand64();
+
+    /* Key of the white side on move */
+    key_white_onmove = rand64();
+}
+
+/* Late move reductions, growing with the logarithms of both the depth left
+ * and the number of the move (in 1/LMR_UNIT plies) */
+static void precompute_reductions(void) {
+    uint32_t d, m;
+
+    for(d = 1; d < MAX_PLY; d++)
+        for(m = 1; m < LMR_MOVES; m++)
+            reductions[d][m] = (uint8_t) MIN(255, LMR_UNIT * (0.5 + log(d) * log(m) / 2.25));
+}
+
+/* Print an array of 'n' values, with 'dim' dimensions of sizes 'size', as
+ * the body of its (braced) initializer. Values are either 64bit or 8bit wide */
+static void print_array(const void *v, const uint32_t *size, uint32_t dim, bool wide, uint32_t indent) {
+    uint32_t i, n, stride;
+
+    /* Number of values on each element of the first dimension */
+    for(stride = 1, i = 1; i < dim; i++)
+        stride *= size[i];
+
+    for(n = 0; n < size[0]; n++) {
+        if(dim > 1) {
+            printf("%*s{\n", indent, "");
+            print_array((const uint8_t *) v + n * stride * (wide ? 8 : 1), &size[1], dim - 1, wide, indent + 1);
+            printf("%*s}%s\n", indent, "", n + 1 < size[0] ? "," : "");
+        } else {
+            if(n % (wide ? 4 : 16) == 0)
+                printf("%*s", indent, "");
+            if(wide)
+                printf("0x%016llXULL", (unsigned long long) ((const uint64_t *) v)[n]);
+            else
+                printf("0x%02X", ((const uint8_t *) v)[n]);
+            if(n + 1 < size[0])
+                printf(",");
+            printf((n + 1) % (wide ? 4 : 16) && n + 1 < size[0] ? " " : "\n");
+        }
+    }
+}
+
+int main(void) {
+    const uint32_t size_board[] = {RANKS, FILES}, size_slide[] = {8, 256},
+        size_king_distance[] = {RANKS, FILES, 8}, size_dist[] = {RANKS, FILES, RANKS, FILES},
+        size_piece[] = {COLORS, PIECES, RANKS, FILES}, size_keys[] = {16},
+        size_rays[] = {DIRECTIONS, RANKS, FILES}, size_reductions[] = {MAX_PLY, LMR_MOVES};
+
+    precompute_moves();
+    precompute_rays();
+    precompute_distances();
+    precompute_zobrist_keys();
+    precompute_reductions();
+
+    printf("/* Generated by tablegen.c -- do not edit */\n");
+    printf("#include \"board.h\"\n#include \"moves.h\"\n#include \"heuristic.h\"\n#include \"search.h\"\n\n");
+
+    printf("/* Boards used in knight's and king's move generation */\n");
+    printf("const bitboard_t moves_knight[8][8] = {\n");
+    print_array(knight_moves, size_board, 2, TRUE, 0);
+    printf("};\n");
+    printf("const bitboard_t moves_king[8][8] = {\n");
+    print_array(king_moves, size_board, 2, TRUE, 0);
+    printf("};\n\n");
+
+    printf("/* Rows used in rook's, bishop's and queen's move generation */\n");
+    printf("const bitline_t moves_slide[8][256] = {\n");
+    print_array(slide_moves, size_slide, 2, FALSE, 0);
+    printf("};\n\n");
+
+    printf("/* Squares on each direction from each square */\n");
+    printf("const bitboard_t rays[DIRECTIONS][RANKS][FILES] = {\n");
+    print_array(ray, size_rays, 3, TRUE, 0);
+    printf("};\n\n");
+
+    printf("/* Squares within each king distance of each square */\n");
+    printf("const bitboard_t king_distance[RANKS][FILES][8] = {\n");
+    print_array(king_distance, size_king_distance, 3, TRUE, 0);
+    printf("};\n\n");
+
+    printf("/* King distance between any two squares */\n");
+    printf("const uint8_t dist[RANKS][FILES][RANKS][FILES] = {\n");
+    print_array(dist, size_dist, 4, FALSE, 0);
+    printf("};\n\n");
+
+    printf("/* Zobrist hash keys, used to determine bitboard hashes */\n");
+    printf("const uint64_t zobrist_piece[COLORS][PIECES][RANKS][FILES] = {\n");
+    print_array(key_piece, size_piece, 4, TRUE, 0);
+    printf("};\n");
+    printf("const uint64_t zobrist_castle[16] = {\n");
+    print_array(key_castle, size_keys, 1, TRUE, 0);
+    printf("};\n");
+    printf("const uint64_t zobrist_enpassant[16] = {\n");
+    print_array(key_enpassant, size_keys, 1, TRUE, 0);
+    printf("};\n");
+    printf("const uint64_t zobrist_white_onmove = 0x%016llXULL;\n\n", (unsigned long long) key_white_onmove);
+
+    printf("/* Late move reductions, by depth left and move number */\n");
+    printf("const uint8_t lmr_reductions[MAX_PLY][LMR_MOVES] = {\n");
+    print_array(reductions, size_reductions, 2, FALSE, 0);
+    printf("};\n");
+
+    return 0;
+}
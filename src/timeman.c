@@ -0,0 +1,102 @@
+/* Copyright (C) 2007-2008 Centro de Computacao Cientifica e Software Livre
+ * Departamento de Informatica - Universidade Federal do Parana - C3SL/UFPR
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301,
+ * USA.
+ */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ChessD BoT - A Free Chess Engine, intended to be used by children and teenagers
+learning how to play Chess.
+
+timeman.c
+Time manager module. Keeps the time control of the game and the clocks sent by
+the chess interface, and plans how long the next search may take: a soft limit,
+after which no new iteration is started, and a hard limit, when the search is
+interrupted by the alarm.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#include "timeman.h"
+
+/* Time control and clocks, as told by the chess interface */
+static time_control_t tc = {0, 0, 0, 0, -1, -1};
+
+/* Set the time control: moves per period (0 for the whole game), time of each
+ * period and increment per move, in milliseconds */
+void set_time_control(uint32_t moves, uint64_t base, uint64_t inc) {
+    tc.moves = moves;
+    tc.base = base;
+    tc.inc = inc;
+    tc.per_move = 0;
+}
+
+/* Set an exact time for each move, in milliseconds */
+void set_time_per_move(uint64_t msec) {
+    tc.per_move = msec;
+}
+
+/* Set the time left on the engine's clock, in milliseconds */
+void set_engine_clock(int64_t msec) {
+    tc.time = msec;
+}
+
+/* Set the time left on the opponent's clock, in milliseconds */
+void set_opponent_clock(int64_t msec) {
+    tc.otim = msec;
+}
+
+/* Forget the clocks (e.g. for a new game), until they are sent again */
+void reset_clocks(void) {
+    tc.time = tc.otim = -1;
+}
+
+/* Plan the time of the next search, for a board, in milliseconds. Without any
+ * clock, or with a clock that allows more than that, the search may take up
+ * to 'max_msec' (the level's limit) */
+void plan_time(board_t *b, uint64_t max_msec, uint64_t *soft, uint64_t *hard) {
+    uint64_t left, moves_to_go;
+
+    /* An exact time per move (still within the level's limit) */
+    if(tc.per_move) {
+        *soft = *hard = MIN(tc.per_move, max_msec);
+        return;
+    }
+
+    /* No clock: the level's limit */
+    if(tc.time < 0) {
+        *soft = *hard = max_msec;
+        return;
+    }
+
+    /* Share the time left among the moves to go until the next time control
+     * (or a guess of them, if it's the last one), plus most of the increment */
+    left = tc.time > MOVE_OVERHEAD ? tc.time - MOVE_OVERHEAD : 1;
+    if(tc.moves)
+        moves_to_go = tc.moves - ((b->fm - 1) % tc.moves);
+    else
+        moves_to_go = MOVES_TO_GO;
+    *soft = left / moves_to_go + tc.inc * 3 / 4;
+    /* With more time than the opponent, we can afford to think a bit more */
+    if(tc.otim >= 0 && tc.time > tc.otim)
+        *soft += *soft / 4;
+
+    /* The hard limit lets a search that's going well finish, but never takes
+     * a large part of the clock */
+    *soft = MIN(*soft, left);
+    *hard = MIN(*soft * HARD_LIMIT_FACTOR, MAX(*soft, left / HARD_LIMIT_SHARE));
+
+    *soft = MIN(*soft, max_msec);
+    *hard = MIN(*hard, max_msec);
+}
@@ -0,0 +1,63 @@
+/* Copyright (C) 2007-2008 Centro de Computacao Cientifica e Software Livre
+ * Departamento de Informatica - Universidade Federal do Parana - C3SL/UFPR
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301,
+ * USA.
+ */
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ChessD BoT - A Free Chess Engine, intended to be used by children and teenagers
+learning how to play Chess.
+
+timeman.h
+Time manager module header file. Contains the constants used to plan the time
+of each search, the time control structure and the function prototypes.
+
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+#ifndef _TIMEMAN_H_
+#define _TIMEMAN_H_
+
+#include "main.h"
+#include "board.h"
+
+/* Time kept on the clock for the communication with the interface (ms) */
+#define MOVE_OVERHEAD 100
+/* Guess of the moves to go, when the whole game has to be played in time */
+#define MOVES_TO_GO 30
+/* The hard limit is up to this times the soft one... */
+#define HARD_LIMIT_FACTOR 4
+/* ...but not more than this part (1/n) of the time left */
+#define HARD_LIMIT_SHARE 4
+/* An iteration usually takes this times as long as the previous one */
+#define ITERATION_GROWTH 3
+
+/* Time control structure */
+typedef struct {
+    uint32_t moves;    /* Moves per period (0 for the whole game) */
+    uint64_t base;     /* Time of each period (ms) */
+    uint64_t inc;      /* Increment per move (ms) */
+    uint64_t per_move; /* Exact time per move (ms), if set */
+    int64_t time;      /* Engine's clock (ms), -1 if unknown */
+    int64_t otim;      /* Opponent's clock (ms), -1 if unknown */
+} time_control_t;
+
+/* Function prototypes */
+void set_time_control(uint32_t moves, uint64_t base, uint64_t inc);
+void set_time_per_move(uint64_t msec);
+void set_engine_clock(int64_t msec);
+void set_opponent_clock(int64_t msec);
+void reset_clocks(void);
+void plan_time(board_t *b, uint64_t max_msec, uint64_t *soft, uint64_t *hard);
+#endif
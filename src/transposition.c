@@ -49,6 +49,13 @@ void init_transposition_table(void) {
     memset(table.transp, 0, table.height * sizeof(transposition_t));
 }
 
+/* Forget every transposition stored in the table */
+void reset_transposition_table(void) {
+    table.entries = 0;
+    if(table.transp)
+    	memset(table.transp, 0, table.height * sizeof(transposition_t));
+}
+
 /* Clean up memory of transposition table */
 void clear_transposition_table(void) {
     if(table.transp)
@@ -56,7 +63,7 @@ void clear_transposition_table(void) {
 }
 
 /* Add new element into transposition table */
-void add_transposition(bitboard_t hash, uint8_t type, uint8_t depth, move_t best) {
+void add_transposition(bitboard_t hash, uint8_t type, uint8_t depth, move_t best, int32_t eval) {
     transposition_t *value;
 
     /* Reference to the tranposition cell, accordingly to the the hash key */
@@ -71,35 +78,22 @@ void add_transposition(bitboard_t hash, uint8_t type, uint8_t depth, move_t best
     value->type = type;
     value->depth = depth;
     value->best = best;
+    value->eval = eval;
 }
 
 /* Query element from transposition table */
-uint8_t query_transposition(bitboard_t hash, int32_t alpha, int32_t beta, uint8_t depth, move_t *best) {
+uint8_t query_transposition(bitboard_t hash, uint8_t depth, int32_t *eval) {
     transposition_t *value = &table.transp[hash % table.height];
 
-    /* Is best moves list empty? */
-    if(best == NULL)
+    /* Is there anywhere to put the evaluation? */
+    if(eval == NULL)
     	return TYPE_INVALID;
 
     /* If it's a hit and the search is deep enough */
     if(value && value->hash == hash && value->depth >= depth) {
-	/* Get the best move (evaluation included) */
-	*best = value->best;
-
-	/* Check if the new eval is better than the stored one */
-    	switch(value->type) {
-	case TYPE_ALPHA:
-	    if(best->eval >= alpha)
-		best->eval = alpha;
-	    break;
-	case TYPE_BETA:
-	    if(best->eval <= beta)
-		best->eval = beta;
-	    break;
-	case TYPE_EXACT:
-	case TYPE_INVALID:
-	    break;
-	}
+	/* Get the evaluation. It's exact, an upper bound (TYPE_ALPHA) or a
+	 * lower bound (TYPE_BETA) */
+	*eval = value->eval;
 	table.hits++;
     	return value->type;
     }
@@ -107,10 +101,33 @@ uint8_t query_transposition(bitboard_t hash, int32_t alpha, int32_t beta, uint8_
     return TYPE_INVALID;
 }
 
+/* Query the best move stored for a position, however shallow its search was.
+ * Returns FALSE if there's none */
+bool query_transposition_move(bitboard_t hash, move_t *m) {
+    transposition_t *value = &table.transp[hash % table.height];
+
+    if(value->hash != hash || value->type == TYPE_INVALID || IS_BLANK_MOVE(value->best))
+    	return FALSE;
+    *m = value->best;
+    return TRUE;
+}
+
+/* Get the number of hits and misses since the statistics were cleared */
+void get_table_stats(uint64_t *hits, uint64_t *misses) {
+    *hits = table.hits;
+    *misses = table.misses;
+}
+
+/* Clear the hits and misses counters of the Transposition Table */
+void clear_table_stats(void) {
+    table.hits = 0;
+    table.misses = 0;
+}
+
 /* Print the statistics of the Transposition Table -- debug only */
 /*
 void print_table_stats(void) {
-    printf("Transposition Table: [Entries: %u/%u] [Hits/Misses: %u/%u]\n", table.entries, table.height, table.hits, table.misses);
+    printf("Transposition Table: [Entries: %u/%u] [Hits/Misses: %llu/%llu]\n", table.entries, table.height, table.hits, table.misses);
 }
 */
 /* Print the entire transposition table -- useful only for debugging */
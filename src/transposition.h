@@ -48,7 +48,8 @@ typedef struct transposition {
     bitboard_t hash;       /* Position hash key */
     uint8_t type  : 2;     /* Type of data stored (alpha, beta or exact eval) */
     uint8_t depth : 6;     /* Depth of evaluation */
-    move_t best;           /* Best move (including evaluation value) */
+    move_t best;           /* Best move */
+    int32_t eval;          /* Evaluation of the board */
 } transposition_t;   /* 15 bytes */
 
 /* The Transposition table itself */
@@ -57,14 +58,18 @@ typedef struct {
     transposition_t *transp;	/* Transposition dynamic-array */
     uint32_t height;		/* Current table height */
     uint32_t entries;		/* Number of transpositions stored */
-    uint32_t hits;		/* Number of successful queries */
-    uint32_t misses;		/* Number of unsuccessful queries */
+    uint64_t hits;		/* Number of successful queries */
+    uint64_t misses;		/* Number of unsuccessful queries */
 } table_t;
 
 void init_transposition_table(void);
+void reset_transposition_table(void);
 void clear_transposition_table(void);
-void add_transposition(bitboard_t hash, uint8_t type, uint8_t depth, move_t best);
-uint8_t query_transposition(bitboard_t hash, int32_t alpha, int32_t beta, uint8_t depth, move_t *m);
+void add_transposition(bitboard_t hash, uint8_t type, uint8_t depth, move_t best, int32_t eval);
+uint8_t query_transposition(bitboard_t hash, uint8_t depth, int32_t *eval);
+bool query_transposition_move(bitboard_t hash, move_t *m);
+void get_table_stats(uint64_t *hits, uint64_t *misses);
+void clear_table_stats(void);
 /*
 void print_table_stats(void);
 void print_table(void);
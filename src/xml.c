@@ -203,24 +203,23 @@ void tag_text(void *data, const XML_Char *txt, int len) {
 	}
 }
 
-/* Parses a XML document. Returns a tree structure
- * accordingly to the document. */
-xml_node_t *xml_parser(char *filename) {
+/* Parses a XML document, calling the given handlers as each element arrives.
+ * No tree is built, so the memory used depends only on the handlers. */
+void xml_stream(char *filename, XML_StartElementHandler start, XML_EndElementHandler end, XML_CharacterDataHandler text, void *data) {
 	XML_Parser parser;
 	FILE *fp;
 	int len;
 	void *buff;
-	xml_node_t *x;
 
 	fp = fopen(filename, "r");
 	if(!fp)
 		quit("Error: Could not open file for XML parse!\n");
 
 	parser = XML_ParserCreate(NULL);
-	x = init_xml_node();
-	XML_SetUserData(parser, &x);
-	XML_SetElementHandler(parser, tag_start, tag_end);
-	XML_SetCharacterDataHandler(parser, tag_text);
+	XML_SetUserData(parser, data);
+	XML_SetElementHandler(parser, start, end);
+	if(text)
+		XML_SetCharacterDataHandler(parser, text);
 
 	while(!feof(fp)) {
 		buff = XML_GetBuffer(parser, XML_BUFF_SIZE);
@@ -234,10 +233,28 @@ xml_node_t *xml_parser(char *filename) {
 	if(!XML_ParseBuffer(parser, 0, 1))
 		quit("Error: Could not parse XML file!\n");
 	XML_ParserFree(parser);
+}
+
+/* Parses a XML document. Returns a tree structure
+ * accordingly to the document. */
+xml_node_t *xml_parser(char *filename) {
+	xml_node_t *x;
+
+	x = init_xml_node();
+	xml_stream(filename, tag_start, tag_end, tag_text, &x);
 
 	return x;
 }
 
+/* Returns the value of an attribute, given the attribute list received by a
+ * streaming start handler (see xml_stream() above). */
+char *get_stream_attribute(const XML_Char **attrs, char *key) {
+	for(; attrs && *attrs; attrs += 2)
+		if(!strcmp(attrs[0], key))
+			return (char *) attrs[1];
+	return NULL;
+}
+
 /* Returns the value of a XML node's attribute. */
 char *get_attribute(xml_node_t *n, char *key) {
 	int i;
@@ -47,6 +47,8 @@ struct _xml_node {
 	xml_node_t *father;
 };
 
+void xml_stream(char *filename, XML_StartElementHandler start, XML_EndElementHandler end, XML_CharacterDataHandler text, void *data);
+char *get_stream_attribute(const XML_Char **attrs, char *key);
 xml_node_t *xml_parser(char *filename);
 void clean_xml_node(xml_node_t *n);
 xml_node_t **get_elements_by_tag_name(xml_node_t *n, char *tag_name);